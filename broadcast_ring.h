@@ -0,0 +1,214 @@
+#ifndef BROADCAST_RING_H_
+#define BROADCAST_RING_H_
+
+#include "cache_line.h"
+#include "wait_strategy.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <initializer_list>
+#include <algorithm>
+
+namespace gl {
+    //single-producer ring every consumer reads in full, as in the LMAX disruptor.
+    //each consumer owns a cursor, the sequence of the next element it will read, and sees an element
+    //once the producer published it and every consumer it depends on has moved past it, so stages
+    //can be chained (a recorder after a parser) without copying. the producer overwrites a slot only
+    //after every consumer moved past it, so it runs at most capacity elements ahead of the slowest.
+    //slots are constructed once and assigned in place; consumers must be added before the producer starts.
+    //consumers that depend on no other consumer wait for the producer to publish, the producer and the
+    //dependent consumers wait for consumers to move, each on its own wait object
+    template<typename T, typename Alloc=std::allocator<T>, typename WaitStrategy=spin_park_wait<>>
+    class broadcast_ring {
+    public:
+        typedef broadcast_ring<T, Alloc, WaitStrategy>  this_type;
+        typedef Alloc                                   allocator_type;
+        typedef std::allocator_traits<allocator_type>   alloc_traits;
+        typedef typename alloc_traits::value_type       value_type;
+        typedef typename alloc_traits::size_type        size_type;
+        typedef typename alloc_traits::pointer          pointer;
+        typedef value_type&                             reference;
+        typedef const value_type&                       const_reference;
+        typedef WaitStrategy                            wait_strategy;
+
+        typedef const value_type& param_value_type;
+
+        class consumer {
+        public:
+            consumer(const consumer&) = delete;
+            consumer& operator=(const consumer&) = delete;
+            //sequence of the next element this consumer reads
+            size_type sequence() const {
+                return d_cursor.load(std::memory_order_relaxed);
+            }
+            //elements ready to be read now
+            size_type available() const {
+                return limit() - d_cursor.load(std::memory_order_relaxed);
+            }
+            //calls f(element) for up to max_n ready elements, then moves the cursor past all of them
+            //at once. returns how many were read, 0 if none was ready
+            template<typename Function>
+            size_type try_consume(Function f, size_type max_n = size_type(-1)){
+                size_type cursor = d_cursor.load(std::memory_order_relaxed);
+                size_type end = d_limit_cache;
+                if(end - cursor < max_n){
+                    end = d_limit_cache = limit();
+                }
+                if(end - cursor > max_n){
+                    end = cursor + max_n;
+                }
+                for(size_type i = cursor; i != end; ++i){
+                    f(static_cast<const_reference>(d_ring->slot(i)));
+                }
+                if(end != cursor){
+                    d_cursor.store(end, std::memory_order_release);
+                    d_ring->d_consumed.notify_all();
+                }
+                return end - cursor;
+            }
+            //as try_consume, but waits until at least one element is ready
+            template<typename Function>
+            size_type consume(Function f, size_type max_n = size_type(-1)){
+                //only this consumer moves its cursor, so what became available stays available.
+                //the consumers it depends on never pass the producer, so only they can hold it back
+                wait_strategy& progress = d_dependencies.empty() ? d_ring->d_published_wait : d_ring->d_consumed;
+                progress.wait([this]()->bool{ return available() != 0; });
+                return try_consume(f, max_n);
+            }
+        private:
+            friend class broadcast_ring;
+            consumer(broadcast_ring* ring, std::vector<const std::atomic<size_type>*> dependencies, size_type start)
+                : d_cursor(start),d_ring(ring),d_dependencies(std::move(dependencies)),d_limit_cache(start) {
+            }
+            size_type limit() const {
+                size_type end = d_ring->d_published.load(std::memory_order_acquire);
+                for(const std::atomic<size_type>* dependency : d_dependencies){
+                    end = std::min(end, dependency->load(std::memory_order_acquire));
+                }
+                return end;
+            }
+        private:
+            _cache_line_pad                                     d_pad0;
+            std::atomic<size_type>                              d_cursor;
+            _cache_line_pad                                     d_pad1;
+            broadcast_ring*                                     d_ring;
+            std::vector<const std::atomic<size_type>*>          d_dependencies;
+            size_type                                           d_limit_cache;
+        };
+    public:
+        //capacity is rounded up to a power of two
+        explicit broadcast_ring(size_type capacity, const allocator_type & alloc = allocator_type())
+            : d_published(0),d_claimed(0),d_gate_cache(0),d_alloc(alloc) {
+            d_capacity = 1;
+            while(d_capacity < capacity){
+                d_capacity <<= 1;
+            }
+            d_slots = alloc_traits::allocate(d_alloc, d_capacity);
+            size_type i = 0;
+            try{
+                for(; i < d_capacity; ++i){
+                    alloc_traits::construct(d_alloc, d_slots + i);
+                }
+            }catch(...){
+                destroy(i);
+                throw;
+            }
+        }
+        broadcast_ring(const broadcast_ring&) = delete;
+        broadcast_ring& operator=(const broadcast_ring&) = delete;
+        ~broadcast_ring() noexcept {
+            destroy(d_capacity);
+        }
+
+        //a consumer that reads everything the producer publishes from now on
+        consumer& add_consumer(){
+            return add_consumer({});
+        }
+        //a consumer that reads an element only after every consumer in after has read it
+        consumer& add_consumer(std::initializer_list<const consumer*> after){
+            std::vector<const std::atomic<size_type>*> dependencies;
+            for(const consumer* c : after){
+                dependencies.push_back(&c->d_cursor);
+            }
+            d_consumers.emplace_back(new consumer(this, std::move(dependencies), d_published.load(std::memory_order_relaxed)));
+            return *d_consumers.back();
+        }
+
+        //producer side. the slot of the next element, waiting until the slowest consumer has
+        //moved past its previous contents; publish() makes it visible
+        reference claim(){
+            d_consumed.wait([this]()->bool{ return has_room(); });
+            return slot(d_claimed);
+        }
+        //nullptr if the slowest consumer is still capacity elements behind
+        pointer try_claim(){
+            return has_room() ? &slot(d_claimed) : nullptr;
+        }
+        void publish(){
+            d_published.store(++d_claimed, std::memory_order_release);
+            d_published_wait.notify_all();
+        }
+        void push(param_value_type value){
+            claim() = value;
+            publish();
+        }
+        bool try_push(param_value_type value){
+            pointer p = try_claim();
+            if(p == nullptr){
+                return false;
+            }
+            *p = value;
+            publish();
+            return true;
+        }
+
+        //sequence of the next element the producer publishes
+        size_type sequence() const {
+            return d_published.load(std::memory_order_relaxed);
+        }
+        size_type capacity() const {
+            return d_capacity;
+        }
+        size_type consumer_count() const {
+            return d_consumers.size();
+        }
+    private:
+        reference slot(size_type sequence){
+            return d_slots[sequence & (d_capacity - 1)];
+        }
+        bool has_room(){
+            if(d_claimed - d_gate_cache < d_capacity){
+                return true;
+            }
+            size_type gate = d_claimed;
+            for(auto& c : d_consumers){
+                gate = std::min(gate, c->d_cursor.load(std::memory_order_acquire));
+            }
+            d_gate_cache = gate;
+            return d_claimed - d_gate_cache < d_capacity;
+        }
+        void destroy(size_type n){
+            for(size_type i = 0; i < n; ++i){
+                alloc_traits::destroy(d_alloc, d_slots + i);
+            }
+            alloc_traits::deallocate(d_alloc, d_slots, d_capacity);
+        }
+    private:
+        _cache_line_pad                                     d_pad0;
+        std::atomic<size_type>                              d_published;
+        //producer's line
+        _cache_line_pad                                     d_pad1;
+        size_type                                           d_claimed;
+        size_type                                           d_gate_cache;
+        pointer                                             d_slots;
+        size_type                                           d_capacity;
+        std::vector<std::unique_ptr<consumer>>              d_consumers;
+        allocator_type                                      d_alloc;
+        _cache_line_pad                                     d_pad2;
+        wait_strategy                                       d_published_wait;
+        _cache_line_pad                                     d_pad3;
+        wait_strategy                                       d_consumed;
+        _cache_line_pad                                     d_pad4;
+    };
+}
+#endif
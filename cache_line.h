@@ -0,0 +1,54 @@
+#ifndef CACHE_LINE_H_
+#define CACHE_LINE_H_
+
+#include<cstddef>
+#include<cstdint>
+#include<memory>
+#include<new>
+#include<utility>
+
+namespace gl {
+    //alignment that keeps data written by different threads off each other's cache lines
+#if defined(__aarch64__) && defined(__APPLE__)
+    const std::size_t cache_line_size = 128;
+#else
+    const std::size_t cache_line_size = 64;
+#endif
+
+    //filler member keeping the members before and after it off each other's cache lines.
+    //alignas would make the enclosing type over-aligned, which plain new, make_shared and
+    //std::vector only honour from C++17
+    struct _cache_line_pad {
+        char bytes[cache_line_size];
+    };
+
+    //deleter of objects made by _make_aligned_unique
+    struct _aligned_delete {
+        template<typename T>
+        void operator()(T* p) const noexcept {
+            p->~T();
+            ::operator delete(reinterpret_cast<void**>(p)[-1]);
+        }
+    };
+    template<typename T>
+    using _aligned_unique_ptr = std::unique_ptr<T, _aligned_delete>;
+
+    //new for types aligned to cache lines. before C++17 operator new only guarantees the
+    //alignment of fundamental types, so this allocates alignof(T) more bytes and keeps the
+    //start of the block just before the object
+    template<typename T, typename ... Args>
+    _aligned_unique_ptr<T> _make_aligned_unique(Args&& ... args){
+        void* block = ::operator new(sizeof(void*) + alignof(T) - 1 + sizeof(T));
+        std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block) + sizeof(void*);
+        address = (address + alignof(T) - 1) & ~std::uintptr_t(alignof(T) - 1);
+        void* object = reinterpret_cast<void*>(address);
+        reinterpret_cast<void**>(object)[-1] = block;
+        try{
+            return _aligned_unique_ptr<T>(::new(object) T(std::forward<Args>(args)...));
+        }catch(...){
+            ::operator delete(block);
+            throw;
+        }
+    }
+}
+#endif
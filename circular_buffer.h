@@ -3,7 +3,15 @@
 
 #include<stdexcept>
 #include<iterator>
+#include<memory>
+#include<algorithm>
+#include<utility>
+#include<type_traits>
+#include<cstring>
 namespace gl {
+    template<typename Iterator>
+    struct segmented_iterator_traits;
+
     template<typename CBType>
     class _circular_buffer_const_iterator
     {
@@ -87,6 +95,10 @@ namespace gl {
         bool operator>=(const this_type& right) {
             return !(*this < right);
         }
+    private:
+        friend CBType;
+        template<typename Iterator>
+        friend struct segmented_iterator_traits;
     private:
         typename CBType::pointer d_ptr;
         const CBType* d_cb;
@@ -166,23 +178,95 @@ namespace gl {
             return *(base_type*)this;
         }
     };
-    template<typename T, typename Alloc=std::allocator<T>>
-    class circular_buffer {
+    //what circular_buffer does when an element is added while it is full()
+    enum cb_full_action {
+        cb_overwrite,   //destroy the oldest element to make room
+        cb_reject,      //drop the new element, the push returns false
+        cb_grow         //reallocate to twice the capacity
+    };
+    template<cb_full_action Action, bool Count = false>
+    struct cb_full_policy {
+        static const cb_full_action action = Action;
+        static const bool count = Count;
+    };
+    typedef cb_full_policy<cb_overwrite>        overwrite_on_full;
+    typedef cb_full_policy<cb_reject>           reject_on_full;
+    typedef cb_full_policy<cb_grow>             grow_on_full;
+    typedef cb_full_policy<cb_overwrite,true>   counted_overwrite_on_full;
+    typedef cb_full_policy<cb_reject,true>      counted_reject_on_full;
+
+    template<typename SizeType, bool Count>
+    class _circular_buffer_full_counter {
+    public:
+        SizeType overwritten_count() const {
+            return d_overwritten;
+        }
+        SizeType rejected_count() const {
+            return d_rejected;
+        }
+        void reset_counters() {
+            d_overwritten = 0;
+            d_rejected = 0;
+        }
+    protected:
+        _circular_buffer_full_counter() :d_overwritten(0),d_rejected(0) {
+        }
+        void count_overwritten(SizeType n) {
+            d_overwritten += n;
+        }
+        void count_rejected(SizeType n) {
+            d_rejected += n;
+        }
+        void swap_counters(_circular_buffer_full_counter& other) {
+            std::swap(d_overwritten,other.d_overwritten);
+            std::swap(d_rejected,other.d_rejected);
+        }
+    private:
+        SizeType d_overwritten;
+        SizeType d_rejected;
+    };
+    template<typename SizeType>
+    class _circular_buffer_full_counter<SizeType, false> {
+    public:
+        SizeType overwritten_count() const {
+            return 0;
+        }
+        SizeType rejected_count() const {
+            return 0;
+        }
+        void reset_counters() {
+        }
+    protected:
+        void count_overwritten(SizeType) {
+        }
+        void count_rejected(SizeType) {
+        }
+        void swap_counters(_circular_buffer_full_counter&) {
+        }
+    };
+
+    template<typename T, typename Alloc=std::allocator<T>, typename FullPolicy=overwrite_on_full>
+    class circular_buffer
+        : public _circular_buffer_full_counter<typename std::allocator_traits<Alloc>::size_type, FullPolicy::count> {
     public:
         typedef Alloc										allocator_type;
-        typedef circular_buffer<T, Alloc>					this_type;
-        typedef typename allocator_type::value_type			value_type;
-        typedef typename allocator_type::size_type			size_type;
-        typedef	typename allocator_type::difference_type	difference_type;
-        typedef typename allocator_type::pointer			pointer;
-        typedef typename allocator_type::const_pointer		const_pointer;
-        typedef typename allocator_type::reference			reference;
-        typedef typename allocator_type::const_reference	const_reference;
+        typedef FullPolicy									full_policy;
+        typedef circular_buffer<T, Alloc, FullPolicy>		this_type;
+        typedef std::allocator_traits<allocator_type>		alloc_traits;
+        typedef typename alloc_traits::value_type			value_type;
+        typedef typename alloc_traits::size_type			size_type;
+        typedef	typename alloc_traits::difference_type		difference_type;
+        typedef typename alloc_traits::pointer				pointer;
+        typedef typename alloc_traits::const_pointer		const_pointer;
+        typedef value_type&									reference;
+        typedef const value_type&							const_reference;
         typedef T&&											rvalue_type;
         typedef _circular_buffer_iterator<this_type>		iterator;
         typedef _circular_buffer_const_iterator<this_type>	const_iterator;
         typedef std::reverse_iterator<iterator>				reverse_iterator;
         typedef std::reverse_iterator<const_iterator>		const_reverse_iterator;
+        typedef std::pair<pointer, size_type>				array_range;
+        typedef std::pair<const_pointer, size_type>			const_array_range;
         
         typedef const value_type& param_value_type;
     public:
@@ -203,12 +287,12 @@ namespace gl {
             init(capacity,size);
             std::uninitialized_fill(d_first, d_last , value);
         }
-        circular_buffer(const circular_buffer< T, Alloc > & other)
+        circular_buffer(const this_type & other)
             : d_alloc(other.d_alloc) {
             init(other.capacity(),other.size());
-            std::uninitialized_copy(other.begin(), other.end(), d_first);
+            copy_from(other);
         }
-        circular_buffer(circular_buffer< T, Alloc > && other) noexcept
+        circular_buffer(this_type && other) noexcept
             : d_alloc(other.d_alloc),d_begin(other.d_begin),d_end(other.d_end),d_first(other.d_first),d_last(other.d_last){
             other.d_begin = nullptr;
             other.d_end = nullptr;
@@ -229,7 +313,7 @@ namespace gl {
             std::uninitialized_copy(first, last, d_first);
             
         }
-        circular_buffer< T, Alloc > & operator=(const circular_buffer< T, Alloc > & other) {
+        this_type & operator=(const this_type & other) {
             if(d_begin){
                 clear();
                 d_alloc.deallocate(d_begin,d_end-d_begin);
@@ -237,15 +321,16 @@ namespace gl {
             d_alloc = other.d_alloc;
             if(other.capacity() > 0){
                 init(other.capacity(),other.size());
-                std::uninitialized_copy(other.begin(), other.end(), d_first);
+                copy_from(other);
             }else{
                 d_begin = nullptr;
                 d_end = nullptr;
                 d_first = nullptr;
                 d_last = nullptr;
             }
+            return *this;
         }
-        circular_buffer< T, Alloc >& operator=(circular_buffer< T, Alloc > && other) noexcept {
+        this_type& operator=(this_type && other) noexcept {
             if(d_begin){
                 clear();
                 d_alloc.deallocate(d_begin,d_end-d_begin);
@@ -259,6 +344,7 @@ namespace gl {
             other.d_end = nullptr;
             other.d_first = nullptr;
             other.d_last = nullptr;
+            return *this;
         }
         ~circular_buffer() noexcept {
             if(d_begin){
@@ -345,7 +431,8 @@ namespace gl {
             return d_first == d_last;
         }
         bool full() const {
-            return size() == capacity();
+            difference_type gap = d_first - d_last;
+            return gap == 1 || gap == (d_begin - d_end) + 1 || d_begin == d_end;
         }
         size_type reserve() const {
             return capacity() - size();
@@ -354,14 +441,59 @@ namespace gl {
             return d_begin == nullptr ? 0 : (d_end - d_begin -1);
         }
         
+        array_range array_one() {
+            return array_range(d_first, is_linearized() ? d_last - d_first : d_end - d_first);
+        }
+        array_range array_two() {
+            return array_range(d_begin, is_linearized() ? 0 : d_last - d_begin);
+        }
+        const_array_range array_one() const {
+            return const_array_range(d_first, is_linearized() ? d_last - d_first : d_end - d_first);
+        }
+        const_array_range array_two() const {
+            return const_array_range(d_begin, is_linearized() ? 0 : d_last - d_begin);
+        }
+        bool is_linearized() const {
+            return d_last >= d_first;
+        }
+        pointer linearize() {
+            if(is_linearized()){
+                return d_first;
+            }
+            //[d_begin,d_last) [d_last,d_first) free [d_first,d_end)
+            //shift the tail segment down into the free gap, then rotate the now contiguous run
+            size_type size_ = size();
+            pointer dst = d_last;
+            for(pointer src = d_first; src != d_end; ++src,++dst){
+                if(dst < d_first){
+                    alloc_traits::construct(d_alloc,dst,std::move(*src));
+                }else{
+                    *dst = std::move(*src);
+                }
+            }
+            for(pointer p = std::max(dst,d_first); p != d_end; ++p){
+                alloc_traits::destroy(d_alloc,p);
+            }
+            std::rotate(d_begin, d_last, dst);
+            d_first = d_begin;
+            d_last = d_begin + size_;
+            return d_first;
+        }
+        
         void set_capacity(size_type __capacity){
-            if(size() > __capacity){
-                this_type temp(__capacity,begin(),begin()+__capacity,d_alloc);
-                swap(temp);
-            }else{
-                this_type temp(__capacity,begin(),end(),d_alloc);
-                swap(temp);
+            if(__capacity == capacity()){
+                return;
             }
+            this_type temp(__capacity,d_alloc);
+            size_type n = std::min(size(), __capacity);
+            size_type n1 = std::min(n, array_one().second);
+            temp.move_back(d_first, n1);
+            temp.move_back(d_begin, n - n1);
+            //the counters stay with this buffer, the newest elements a shrink drops count as overwritten
+            size_type dropped = size() - n;
+            swap(temp);
+            this->swap_counters(temp);
+            this->count_overwritten(dropped);
         }
         
         void resize(size_type __size, param_value_type value = value_type()){
@@ -372,237 +504,290 @@ namespace gl {
             }
         }
         
-        void swap(circular_buffer< T, Alloc > & other) noexcept{
+        void swap(this_type & other) noexcept{
             std::swap(d_alloc,other.d_alloc);
             std::swap(d_begin,other.d_begin);
             std::swap(d_end,other.d_end);
             std::swap(d_first,other.d_first);
             std::swap(d_last,other.d_last);
+            this->swap_counters(other);
         }
-        void push_back(param_value_type value) {
-            if(capacity()==0){
-                return;
-            }
-            if (full()) {
-                d_alloc.destroy(d_first);
-                increment(d_first);
+        bool push_back(param_value_type value) {
+            if(full() && !make_room_back()){
+                return false;
             }
-            d_alloc.construct(d_last,value);
+            alloc_traits::construct(d_alloc,d_last,value);
             increment(d_last);
+            return true;
         }
-        void push_back(rvalue_type rvalue) {
-            if(capacity()==0){
-                return;
+        bool push_back(rvalue_type rvalue) {
+            if(full() && !make_room_back()){
+                return false;
             }
-            if (full()) {
-                d_alloc.destroy(d_first);
-                increment(d_first);
-            }
-            d_alloc.construct(d_last,std::move(rvalue));
+            alloc_traits::construct(d_alloc,d_last,std::move(rvalue));
             increment(d_last);
+            return true;
         }
         template <typename ... Args>
-        void emplace_back(Args&& ... args){
-            if(capacity()==0){
-                return;
-            }
-            if (full()) {
-                d_alloc.destroy(d_first);
-                increment(d_first);
+        bool emplace_back(Args&& ... args){
+            if(full() && !make_room_back()){
+                return false;
             }
-            d_alloc.construct(d_last,std::forward<Args>(args)...);
+            alloc_traits::construct(d_alloc,d_last,std::forward<Args>(args)...);
             increment(d_last);
+            return true;
         }
-        void push_front(param_value_type value){
-            if(capacity()==0){
-                return;
+        template<typename InputIterator>
+        size_type push_back(InputIterator first, InputIterator last){
+            size_type n = std::distance(first, last);
+            if(n > reserve()){
+                iterator pos = end();
+                n = make_room_insert(pos, n);
             }
-            if (full()) {
-                decrement(d_last);
-                d_alloc.destroy(d_last);
+            if(n == 0){
+                return 0;
             }
-            decrement(d_first);
-            d_alloc.construct(d_first,value);
+            if(n >= capacity()){
+                clear();
+                std::advance(first, n - capacity());
+                n = capacity();
+            }else if(n > reserve()){
+                erase_begin(n - reserve());
+            }
+            copy_in(first, n, d_last);
+            d_last = add(d_last, n);
+            return n;
         }
-        void push_front(rvalue_type rvalue){
-            if(capacity()==0){
-                return;
+        bool push_front(param_value_type value){
+            if(full() && !make_room_front()){
+                return false;
             }
-            if (full()) {
-                decrement(d_last);
-                d_alloc.destroy(d_last);
+            decrement(d_first);
+            alloc_traits::construct(d_alloc,d_first,value);
+            return true;
+        }
+        bool push_front(rvalue_type rvalue){
+            if(full() && !make_room_front()){
+                return false;
             }
             decrement(d_first);
-            d_alloc.construct(d_first,std::move(rvalue));
+            alloc_traits::construct(d_alloc,d_first,std::move(rvalue));
+            return true;
         }
         template <typename ... Args>
-        void emplace_front(Args&& ... args){
-            if(capacity()==0){
-                return;
-            }
-            if (full()) {
-                decrement(d_last);
-                d_alloc.destroy(d_last);
+        bool emplace_front(Args&& ... args){
+            if(full() && !make_room_front()){
+                return false;
             }
             decrement(d_first);
-            d_alloc.construct(d_first,std::forward<Args>(args)...);
+            alloc_traits::construct(d_alloc,d_first,std::forward<Args>(args)...);
+            return true;
         }
         
         void pop_back(){
             decrement(d_last);
-            d_alloc.destroy(d_last);
+            alloc_traits::destroy(d_alloc,d_last);
         }
         void pop_front(){
-            d_alloc.destroy(d_first);
+            alloc_traits::destroy(d_alloc,d_first);
             increment(d_first);
         }
+        template<typename OutputIterator>
+        size_type pop_front(OutputIterator out, size_type n){
+            n = std::min(n, size());
+            size_type n1 = std::min<size_type>(n, d_end - d_first);
+            out = move_out(d_first, n1, out);
+            move_out(d_begin, n - n1, out);
+            erase_begin(n);
+            return n;
+        }
         
         iterator insert(iterator pos, param_value_type value){
-            if(pos == begin()){
-                std::copy_backward(std::move_iterator<iterator>(pos),std::move_iterator<iterator>(end()-1),end());
-                *pos = value;
-                return pos;
+            if(full() && make_room_insert(pos, 1) == 0){
+                return end();
             }
-            if (full()) {
-                d_alloc.destroy(d_first);
-                increment(d_first);
+            size_type n = 1, skip;
+            pointer p = insert_gap(pos, n, skip);
+            if(n == 0){
+                return begin();
             }
-            if(pos == end()){
-                d_alloc.construct(d_last,value);
-            }else{
-                d_alloc.construct(d_last,std::move(*rbegin()));
-                std::copy_backward(std::move_iterator<iterator>(pos),std::move_iterator<iterator>(end()-1),end());
-                *pos = value;
-            }
-            increment(d_last);
-            return pos;
+            alloc_traits::construct(d_alloc,p,value);
+            return iterator(this,p);
         }
         iterator insert(iterator pos, rvalue_type rvalue){
-            if(pos == begin()){
-                std::copy_backward(std::move_iterator<iterator>(pos),std::move_iterator<iterator>(end()-1),end());
-                *pos = std::move(rvalue);
-                return pos;
-            }
-            if (full()) {
-                d_alloc.destroy(d_first);
-                increment(d_first);
+            if(full() && make_room_insert(pos, 1) == 0){
+                return end();
             }
-            if(pos == end()){
-                d_alloc.construct(d_last,std::move(rvalue));
-            }else{
-                d_alloc.construct(d_last,std::move(*rbegin()));
-                std::copy_backward(std::move_iterator<iterator>(pos),std::move_iterator<iterator>(end()-1),end());
-                *pos = std::move(rvalue);
+            size_type n = 1, skip;
+            pointer p = insert_gap(pos, n, skip);
+            if(n == 0){
+                return begin();
             }
-            increment(d_last);
-            return pos;
+            alloc_traits::construct(d_alloc,p,std::move(rvalue));
+            return iterator(this,p);
         }
         void insert(iterator pos, size_type n, param_value_type value){
-            size_type max_insert_n = capacity() - (end() - pos);
-            if(n >= max_insert_n){
-                for(auto iter = begin(); iter != pos; ++iter){
-                    d_alloc.destroy(&*iter);
-                }
-                d_first = add(d_last , 1);
-                std::uninitialized_fill(begin(), begin()+max_insert_n, value);
-            }else{
-                if(n > reserve()){
-                    size_type destroy_count = n - reserve();
-                    for(auto iter = begin(),end_iter = begin() + destroy_count; iter != end_iter; ++iter){
-                        d_alloc.destroy(&*iter);
-                    }
-                    d_first = add(d_first, destroy_count);
-                }
-                size_type move_count = end() - pos;
-                if(n >= move_count){//not overlay
-                    std::uninitialized_copy(pos,  end(),  pos + n);
-                    for(auto iter = pos; iter != end(); ++iter){
-                        d_alloc.destroy(&*iter);
-                    }
-                }else{ //overlay
-                    std::uninitialized_copy(end()-n,end(),end());//not overlay
-                    std::copy_backward(std::move_iterator<iterator>(pos),std::move_iterator<iterator>(pos+(move_count-n)),end());//overlay
-                    for(auto iter = pos,end_iter = pos + n; iter != end_iter; ++iter){
-                        d_alloc.destroy(&*iter);
-                    }
-                }
-                std::uninitialized_fill(pos, pos+n, value);
-                d_last = add(d_last,n);
+            if(n > reserve()){
+                n = make_room_insert(pos, n);
+            }
+            if(n == 0){
+                return;
+            }
+            size_type skip;
+            pointer p = insert_gap(pos, n, skip);
+            for(; n > 0; --n){
+                alloc_traits::construct(d_alloc,p,value);
+                increment(p);
             }
         }
         template<typename InputIterator>
-        void insert(iterator pos, InputIterator __begin, InputIterator __end){
-            difference_type n = std::distance(__begin, __end);
-            size_type max_insert_n = capacity() - (end() - pos);
-            if(n >= max_insert_n){
-                for(auto iter = begin(); iter != pos; ++iter){
-                    d_alloc.destroy(&*iter);
-                }
-                d_first = add(d_last,1);
-                InputIterator new_begin = __begin;
-                std::advance(new_begin, n-max_insert_n);
-                std::uninitialized_copy(new_begin, __end, begin());
-            }else{
-                if(n > reserve()){
-                    size_type destroy_count = n - reserve();
-                    for(auto iter = begin(),end_iter = begin() + destroy_count; iter != end_iter; ++iter){
-                        d_alloc.destroy(&*iter);
-                    }
-                    d_first = add(d_first, destroy_count);
-                }
-                size_type move_count = end() - pos;
-                if(n >= move_count){//not overlay
-                    std::uninitialized_copy(pos,  end(),  pos + n);
-                    for(auto iter = pos; iter != end(); ++iter){
-                        d_alloc.destroy(&*iter);
-                    }
-                }else{ //overlay
-                    std::uninitialized_copy(end()-n,end(),end());//not overlay
-                    std::copy_backward(std::move_iterator<iterator>(pos),std::move_iterator<iterator>(pos+(move_count-n)),end());//overlay
-                    for(auto iter = pos,end_iter = pos + n; iter != end_iter; ++iter){
-                        d_alloc.destroy(&*iter);
-                    }
-                }
-                std::uninitialized_copy(__begin, __end, pos);
-                d_last = add(d_last,n);
+        void insert(iterator pos, InputIterator __begin, InputIterator __end,
+                    typename std::enable_if<!std::is_integral<InputIterator>::value>::type* = nullptr){
+            size_type n = std::distance(__begin, __end);
+            if(n > reserve()){
+                n = make_room_insert(pos, n);
+            }
+            if(n == 0){
+                return;
             }
+            size_type skip;
+            pointer p = insert_gap(pos, n, skip);
+            std::advance(__begin, skip);
+            copy_in(__begin, n, p);
         }
         
         iterator erase(iterator pos){
             return erase(pos,pos+1);
         }
         iterator erase(iterator __begin, iterator __end){
-            std::copy(std::move_iterator<iterator>(__end),std::move_iterator<iterator>(this->end()),__begin);
-            size_type n = __end - __begin;
-            for(auto iter = rbegin(),iter_end = rbegin() + n; iter != iter_end; ++iter){
-                d_alloc.destroy(&*iter);
-            }
-            d_last = sub(d_last,n);
-            return __begin;
+            size_type index = __begin - begin();
+            close_gap(index, __end - __begin);
+            return begin() + index;
         }
         
         void erase_begin(size_type n){
-            for(auto iter = begin(),end = begin()+n; iter != end; ++iter){
-                d_alloc.destroy(&*iter);
-            }
+            destroy_n(d_first, n);
             d_first = add(d_first,n);
         }
         void erase_end(size_type n){
-            for(auto iter = rbegin(),end = rbegin()+n; iter != end; ++iter){
-                d_alloc.destroy(&*iter);
-            }
             d_last = sub(d_last,n);
+            destroy_n(d_last, n);
         }
         void clear() {
             if(!empty()){
-                for(auto iter = begin(); iter != end(); ++iter){
-                    d_alloc.destroy(&*iter);
-                }
+                destroy_n(d_first, size());
                 d_first = d_begin;
                 d_last = d_begin;
             }
         }
     private:
+        //returns the first slot of an uninitialized gap for n new elements before pos.
+        //if n > reserve() the oldest elements are dropped to fit, and once everything before pos
+        //is gone the first skip new elements are dropped too; n becomes the size of the gap
+        pointer insert_gap(iterator pos, size_type& n, size_type& skip){
+            size_type index = pos - begin();
+            skip = 0;
+            if(n > reserve()){
+                size_type drop = n - reserve();
+                size_type erased = std::min(drop, index);
+                erase_begin(erased);
+                index -= erased;
+                skip = drop - erased;
+                n -= skip;
+            }
+            return open_gap(index, n);
+        }
+        //like a deque, middle edits relocate whichever side of the edit point is shorter:
+        //open_gap moves the elements before index n slots towards the front or the ones after it
+        //n slots towards the back and returns the first slot of the gap, which is left uninitialized.
+        //requires n <= reserve()
+        pointer open_gap(size_type index, size_type n){
+            if(n == 0){
+                return add(d_first, index);
+            }
+            if(index < size() - index){
+                open_gap_front(index, n, std::is_trivially_copyable<value_type>());
+                d_first = sub(d_first, n);
+            }else{
+                open_gap_back(index, n, std::is_trivially_copyable<value_type>());
+                d_last = add(d_last, n);
+            }
+            return add(d_first, index);
+        }
+        void open_gap_front(size_type index, size_type n, std::true_type){
+            shift_slots(d_first, index, -(difference_type)n);
+        }
+        void open_gap_front(size_type index, size_type n, std::false_type){
+            pointer s = d_first;
+            pointer d = sub(d_first, n);
+            for(size_type i = 0; i < index; ++i){
+                if(i < n){
+                    alloc_traits::construct(d_alloc,d,std::move(*s));
+                }else{
+                    *d = std::move(*s);
+                }
+                increment(s);
+                increment(d);
+            }
+            size_type moved_from = std::min(n, index);
+            destroy_n(sub(s, moved_from), moved_from);
+        }
+        void open_gap_back(size_type index, size_type n, std::true_type){
+            shift_slots(add(d_first, index), size() - index, n);
+        }
+        void open_gap_back(size_type index, size_type n, std::false_type){
+            size_type tail = size() - index;
+            pointer s = d_last;
+            pointer d = add(d_last, n);
+            for(size_type i = 0; i < tail; ++i){
+                decrement(s);
+                decrement(d);
+                if(i < n){
+                    alloc_traits::construct(d_alloc,d,std::move(*s));
+                }else{
+                    *d = std::move(*s);
+                }
+            }
+            destroy_n(s, std::min(n, tail));
+        }
+        //removes the n elements starting at index by relocating the shorter side over them
+        void close_gap(size_type index, size_type n){
+            if(n == 0){
+                return;
+            }
+            size_type tail = size() - index - n;
+            if(index < tail){
+                close_gap_front(index, n, std::is_trivially_copyable<value_type>());
+                d_first = add(d_first, n);
+            }else{
+                close_gap_back(index, n, std::is_trivially_copyable<value_type>());
+                d_last = sub(d_last, n);
+            }
+        }
+        void close_gap_front(size_type index, size_type n, std::true_type){
+            shift_slots(d_first, index, n);
+        }
+        void close_gap_front(size_type index, size_type n, std::false_type){
+            pointer s = add(d_first, index);
+            pointer d = add(s, n);
+            for(size_type i = 0; i < index; ++i){
+                decrement(s);
+                decrement(d);
+                *d = std::move(*s);
+            }
+            destroy_n(d_first, n);
+        }
+        void close_gap_back(size_type index, size_type n, std::true_type){
+            shift_slots(add(d_first, index + n), size() - index - n, -(difference_type)n);
+        }
+        void close_gap_back(size_type index, size_type n, std::false_type){
+            pointer d = add(d_first, index);
+            pointer s = add(d, n);
+            for(; s != d_last; increment(s),increment(d)){
+                *d = std::move(*s);
+            }
+            destroy_n(d, n);
+        }
         void init(size_type capacity, size_type size){
             d_begin = d_alloc.allocate(capacity + 1);
             d_end   = d_begin + capacity + 1;
@@ -643,6 +828,173 @@ namespace gl {
         difference_type distance(pointer p1,pointer p2) const{
             return linearize(p1) - linearize(p2);
         }
+        template<typename Iterator>
+        struct is_memcpyable : std::integral_constant<bool,
+            std::is_trivially_copyable<value_type>::value && std::is_pointer<Iterator>::value
+            && std::is_same<typename std::remove_cv<typename std::remove_pointer<Iterator>::type>::type,value_type>::value>{
+        };
+        //construct n elements read from src into the slots starting at dst, wrapping at d_end
+        template<typename InputIterator>
+        InputIterator copy_in(InputIterator src, size_type n, pointer dst){
+            size_type n1 = std::min<size_type>(n, d_end - dst);
+            src = copy_in(src, n1, dst, is_memcpyable<InputIterator>());
+            return copy_in(src, n - n1, d_begin, is_memcpyable<InputIterator>());
+        }
+        template<typename InputIterator>
+        InputIterator copy_in(InputIterator src, size_type n, pointer dst, std::true_type){
+            if(n > 0){
+                std::memcpy(dst, src, n * sizeof(value_type));
+            }
+            return src + n;
+        }
+        template<typename InputIterator>
+        InputIterator copy_in(InputIterator src, size_type n, pointer dst, std::false_type){
+            for(; n > 0; --n,++src,++dst){
+                alloc_traits::construct(d_alloc,dst,*src);
+            }
+            return src;
+        }
+        //move n contiguous elements starting at src to out
+        template<typename OutputIterator>
+        OutputIterator move_out(pointer src, size_type n, OutputIterator out){
+            return move_out(src, n, out, is_memcpyable<OutputIterator>());
+        }
+        template<typename OutputIterator>
+        OutputIterator move_out(pointer src, size_type n, OutputIterator out, std::true_type){
+            if(n > 0){
+                std::memcpy(out, src, n * sizeof(value_type));
+            }
+            return out + n;
+        }
+        template<typename OutputIterator>
+        OutputIterator move_out(pointer src, size_type n, OutputIterator out, std::false_type){
+            return std::move(src, src + n, out);
+        }
+        typedef std::integral_constant<cb_full_action, full_policy::action> full_action_tag;
+        typedef std::integral_constant<cb_full_action, cb_overwrite>        overwrite_tag;
+        typedef std::integral_constant<cb_full_action, cb_reject>           reject_tag;
+        typedef std::integral_constant<cb_full_action, cb_grow>             grow_tag;
+        //called when full(), returns false if the new element must be dropped
+        bool make_room_back(){
+            return make_room_back(full_action_tag());
+        }
+        bool make_room_back(overwrite_tag){
+            //with no capacity there is nothing to overwrite, the new element is dropped
+            if(capacity()==0){
+                this->count_rejected(1);
+                return false;
+            }
+            this->count_overwritten(1);
+            alloc_traits::destroy(d_alloc,d_first);
+            increment(d_first);
+            return true;
+        }
+        bool make_room_back(reject_tag){
+            this->count_rejected(1);
+            return false;
+        }
+        bool make_room_back(grow_tag){
+            set_capacity(capacity() == 0 ? 1 : capacity() * 2);
+            return true;
+        }
+        bool make_room_front(){
+            return make_room_front(full_action_tag());
+        }
+        bool make_room_front(overwrite_tag){
+            if(capacity()==0){
+                this->count_rejected(1);
+                return false;
+            }
+            this->count_overwritten(1);
+            decrement(d_last);
+            alloc_traits::destroy(d_alloc,d_last);
+            return true;
+        }
+        bool make_room_front(reject_tag){
+            this->count_rejected(1);
+            return false;
+        }
+        bool make_room_front(grow_tag){
+            return make_room_back(grow_tag());
+        }
+        //called when n > reserve() before inserting n elements at pos, returns how many may be inserted.
+        //overwrite leaves dropping the oldest elements to the insert itself.
+        size_type make_room_insert(iterator& pos, size_type n){
+            return make_room_insert(pos, n, full_action_tag());
+        }
+        size_type make_room_insert(iterator&, size_type n, overwrite_tag){
+            if(capacity()==0){
+                this->count_rejected(n);
+                return 0;
+            }
+            this->count_overwritten(size() + n - capacity());
+            return n;
+        }
+        size_type make_room_insert(iterator&, size_type n, reject_tag){
+            this->count_rejected(n - reserve());
+            return reserve();
+        }
+        size_type make_room_insert(iterator& pos, size_type n, grow_tag){
+            size_type index = pos - begin();
+            set_capacity(std::max(capacity() * 2, size() + n));
+            pos = begin() + index;
+            return n;
+        }
+        //append n elements moved out of the contiguous range starting at src
+        void move_back(pointer src, size_type n){
+            move_back(src, n, std::is_trivially_copyable<value_type>());
+        }
+        void move_back(pointer src, size_type n, std::true_type){
+            copy_in(src, n, d_last);
+            d_last = add(d_last, n);
+        }
+        void move_back(pointer src, size_type n, std::false_type){
+            copy_in(std::make_move_iterator(src), n, d_last);
+            d_last = add(d_last, n);
+        }
+        void copy_from(const this_type& other){
+            const_array_range one = other.array_one();
+            const_array_range two = other.array_two();
+            copy_in(one.first, one.second, d_first);
+            copy_in(two.first, two.second, d_first + one.second);
+        }
+        void destroy_n(pointer p, size_type n){
+            destroy_n(p, n, std::is_trivially_destructible<value_type>());
+        }
+        void destroy_n(pointer, size_type, std::true_type){
+        }
+        void destroy_n(pointer p, size_type n, std::false_type){
+            for(; n > 0; --n){
+                alloc_traits::destroy(d_alloc,p);
+                increment(p);
+            }
+        }
+        //memmove count slots starting at src by delta positions, delta > 0 moves towards d_last.
+        //only valid for trivially copyable value_type
+        void shift_slots(pointer src, size_type count, difference_type delta){
+            if(delta > 0){
+                pointer s = add(src, count);
+                pointer d = add(s, delta);
+                while(count > 0){
+                    size_type k = std::min<size_type>(count, std::min(s == d_begin ? d_end - d_begin : s - d_begin,
+                                                                      d == d_begin ? d_end - d_begin : d - d_begin));
+                    s = sub(s, k);
+                    d = sub(d, k);
+                    std::memmove(d, s, k * sizeof(value_type));
+                    count -= k;
+                }
+            }else if(delta < 0){
+                pointer s = src;
+                pointer d = sub(src, -delta);
+                while(count > 0){
+                    size_type k = std::min<size_type>(count, std::min(d_end - s, d_end - d));
+                    std::memmove(d, s, k * sizeof(value_type));
+                    s = add(s, k);
+                    d = add(d, k);
+                    count -= k;
+                }
+            }
+        }
         bool less(pointer p1,pointer p2) const{
             if( (p1 >= d_first && p2 >= d_first)
                || (p1 < d_first && p2 < d_first)){
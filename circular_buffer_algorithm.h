@@ -0,0 +1,198 @@
+#ifndef CIRCULAR_BUFFER_ALGORITHM_H_
+#define CIRCULAR_BUFFER_ALGORITHM_H_
+
+#include "circular_buffer.h"
+#include "pow2_circular_buffer.h"
+#include "static_circular_buffer.h"
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
+namespace gl {
+    //splits the n elements starting at p, which lies in one of the two runs of a ring,
+    //at the wrap point and calls f on each contiguous piece
+    template<typename Pointer, typename Range, typename Function>
+    void _for_each_ring_segment(Pointer p, std::size_t n, const Range& one, const Range& two, Function& f) {
+        if(n == 0){
+            return;
+        }
+        if(p >= one.first && p < one.first + one.second){
+            std::size_t run = std::min<std::size_t>(n, one.first + one.second - p);
+            f(p, p + run);
+            if(n > run){
+                Pointer second = const_cast<Pointer>(two.first);
+                f(second, second + (n - run));
+            }
+        }else{
+            f(p, p + n);
+        }
+    }
+
+    //same for a power of two ring addressed by a masked counter
+    template<typename Pointer, typename Buffer, typename Function>
+    void _for_each_pow2_segment(Buffer buffer, std::size_t mask, std::size_t index, std::size_t n, Function& f) {
+        if(n == 0){
+            return;
+        }
+        Pointer p = buffer + (index & mask);
+        std::size_t run = std::min<std::size_t>(n, mask + 1 - (index & mask));
+        f(p, p + run);
+        if(n > run){
+            f(Pointer(buffer), Pointer(buffer) + (n - run));
+        }
+    }
+
+    //iterators that are not segmented form one segment
+    template<typename Iterator>
+    struct segmented_iterator_traits {
+        typedef std::false_type is_segmented;
+        typedef Iterator        segment_iterator;
+        template<typename Function>
+        static void for_each_segment(Iterator first, Iterator last, Function& f) {
+            f(first, last);
+        }
+    };
+    template<typename CBType>
+    struct segmented_iterator_traits<_circular_buffer_const_iterator<CBType>> {
+        typedef std::true_type                  is_segmented;
+        typedef typename CBType::const_pointer  segment_iterator;
+        template<typename Function>
+        static void for_each_segment(const _circular_buffer_const_iterator<CBType>& first,
+                                     const _circular_buffer_const_iterator<CBType>& last, Function& f) {
+            _for_each_ring_segment<segment_iterator>(first.d_ptr, last - first, first.d_cb->array_one(), first.d_cb->array_two(), f);
+        }
+    };
+    template<typename CBType>
+    struct segmented_iterator_traits<_circular_buffer_iterator<CBType>> {
+        typedef std::true_type              is_segmented;
+        typedef typename CBType::pointer    segment_iterator;
+        template<typename Function>
+        static void for_each_segment(const _circular_buffer_iterator<CBType>& first,
+                                     const _circular_buffer_iterator<CBType>& last, Function& f) {
+            _for_each_ring_segment<segment_iterator>(first.d_ptr, last - first, first.d_cb->array_one(), first.d_cb->array_two(), f);
+        }
+    };
+    template<typename CBType>
+    struct segmented_iterator_traits<_pow2_circular_buffer_const_iterator<CBType>> {
+        typedef std::true_type                  is_segmented;
+        typedef typename CBType::const_pointer  segment_iterator;
+        template<typename Function>
+        static void for_each_segment(const _pow2_circular_buffer_const_iterator<CBType>& first,
+                                     const _pow2_circular_buffer_const_iterator<CBType>& last, Function& f) {
+            _for_each_pow2_segment<segment_iterator>(first.d_buffer, first.d_mask, first.d_index, last - first, f);
+        }
+    };
+    template<typename CBType>
+    struct segmented_iterator_traits<_pow2_circular_buffer_iterator<CBType>> {
+        typedef std::true_type              is_segmented;
+        typedef typename CBType::pointer    segment_iterator;
+        template<typename Function>
+        static void for_each_segment(const _pow2_circular_buffer_iterator<CBType>& first,
+                                     const _pow2_circular_buffer_iterator<CBType>& last, Function& f) {
+            const _pow2_circular_buffer_const_iterator<CBType>& iter = first;
+            _for_each_pow2_segment<segment_iterator>(iter.d_buffer, iter.d_mask, iter.d_index, last - first, f);
+        }
+    };
+    template<typename CBType>
+    struct segmented_iterator_traits<_static_circular_buffer_const_iterator<CBType>> {
+        typedef std::true_type                  is_segmented;
+        typedef typename CBType::const_pointer  segment_iterator;
+        template<typename Function>
+        static void for_each_segment(const _static_circular_buffer_const_iterator<CBType>& first,
+                                     const _static_circular_buffer_const_iterator<CBType>& last, Function& f) {
+            if(first != last){
+                _for_each_ring_segment<segment_iterator>(&(*first.d_cb)[first.d_index], last - first,
+                                                         first.d_cb->array_one(), first.d_cb->array_two(), f);
+            }
+        }
+    };
+    template<typename CBType>
+    struct segmented_iterator_traits<_static_circular_buffer_iterator<CBType>> {
+        typedef std::true_type              is_segmented;
+        typedef typename CBType::pointer    segment_iterator;
+        template<typename Function>
+        static void for_each_segment(const _static_circular_buffer_iterator<CBType>& first,
+                                     const _static_circular_buffer_iterator<CBType>& last, Function& f) {
+            const _static_circular_buffer_const_iterator<CBType>& iter = first;
+            if(first != last){
+                _for_each_ring_segment<segment_iterator>(const_cast<segment_iterator>(&(*iter.d_cb)[iter.d_index]), last - first,
+                                                         iter.d_cb->array_one(), iter.d_cb->array_two(), f);
+            }
+        }
+    };
+
+    //calls f(segment_first, segment_last) for each contiguous piece of [first,last),
+    //with raw pointers for ring buffer iterators so the work on each piece can vectorize
+    template<typename Iterator, typename Function>
+    Function for_each_segment(Iterator first, Iterator last, Function f) {
+        segmented_iterator_traits<Iterator>::for_each_segment(first, last, f);
+        return f;
+    }
+
+    //the algorithms below only take ring buffer iterators, so they never compete with the std::
+    //algorithms that argument dependent lookup also finds for other iterators
+    template<typename Iterator, typename Result>
+    struct _enable_if_segmented
+        : std::enable_if<segmented_iterator_traits<Iterator>::is_segmented::value, Result> {
+    };
+
+    template<typename InputIterator, typename OutputIterator>
+    typename _enable_if_segmented<InputIterator, OutputIterator>::type copy(InputIterator first, InputIterator last, OutputIterator out) {
+        typedef typename segmented_iterator_traits<InputIterator>::segment_iterator segment_iterator;
+        for_each_segment(first, last, [&out](segment_iterator __first, segment_iterator __last){
+            out = std::copy(__first, __last, out);
+        });
+        return out;
+    }
+    template<typename InputIterator, typename OutputIterator, typename UnaryOperation>
+    typename _enable_if_segmented<InputIterator, OutputIterator>::type transform(InputIterator first, InputIterator last, OutputIterator out, UnaryOperation op) {
+        typedef typename segmented_iterator_traits<InputIterator>::segment_iterator segment_iterator;
+        for_each_segment(first, last, [&out,&op](segment_iterator __first, segment_iterator __last){
+            out = std::transform(__first, __last, out, op);
+        });
+        return out;
+    }
+    template<typename ForwardIterator, typename T>
+    typename _enable_if_segmented<ForwardIterator, void>::type fill(ForwardIterator first, ForwardIterator last, const T& value) {
+        typedef typename segmented_iterator_traits<ForwardIterator>::segment_iterator segment_iterator;
+        for_each_segment(first, last, [&value](segment_iterator __first, segment_iterator __last){
+            std::fill(__first, __last, value);
+        });
+    }
+    template<typename InputIterator, typename T>
+    typename _enable_if_segmented<InputIterator, T>::type accumulate(InputIterator first, InputIterator last, T init) {
+        typedef typename segmented_iterator_traits<InputIterator>::segment_iterator segment_iterator;
+        for_each_segment(first, last, [&init](segment_iterator __first, segment_iterator __last){
+            init = std::accumulate(__first, __last, init);
+        });
+        return init;
+    }
+    template<typename InputIterator, typename T, typename BinaryOperation>
+    typename _enable_if_segmented<InputIterator, T>::type accumulate(InputIterator first, InputIterator last, T init, BinaryOperation op) {
+        typedef typename segmented_iterator_traits<InputIterator>::segment_iterator segment_iterator;
+        for_each_segment(first, last, [&init,&op](segment_iterator __first, segment_iterator __last){
+            init = std::accumulate(__first, __last, init, op);
+        });
+        return init;
+    }
+    template<typename InputIterator, typename T>
+    typename _enable_if_segmented<InputIterator, InputIterator>::type find(InputIterator first, InputIterator last, const T& value) {
+        typedef typename segmented_iterator_traits<InputIterator>::segment_iterator segment_iterator;
+        typename std::iterator_traits<InputIterator>::difference_type offset = 0;
+        bool found = false;
+        for_each_segment(first, last, [&](segment_iterator __first, segment_iterator __last){
+            if(found){
+                return;
+            }
+            segment_iterator iter = std::find(__first, __last, value);
+            offset += std::distance(__first, iter);
+            found = iter != __last;
+        });
+        if(!found){
+            return last;
+        }
+        std::advance(first, offset);
+        return first;
+    }
+}
+#endif
@@ -0,0 +1,319 @@
+#ifndef CIRCULAR_BUFFER_SPACE_OPTIMIZED_H_
+#define CIRCULAR_BUFFER_SPACE_OPTIMIZED_H_
+
+#include "circular_buffer.h"
+
+namespace gl {
+    //releases committed storage once it is no more than 1/divisor full,
+    //keeping twice the current size so the buffer does not thrash between grow and shrink.
+    //a divisor of 0 never shrinks.
+    class space_optimized_shrink_policy {
+    public:
+        explicit space_optimized_shrink_policy(std::size_t divisor = 4)
+            : d_divisor(divisor) {
+        }
+        std::size_t shrink_to(std::size_t size, std::size_t allocated) const {
+            if(d_divisor == 0 || size * d_divisor > allocated){
+                return allocated;
+            }
+            return size * 2;
+        }
+    private:
+        std::size_t d_divisor;
+    };
+
+    //circular_buffer with the same interface which commits its storage lazily:
+    //the internal buffer grows geometrically up to capacity() as elements are added
+    //and is released again according to ShrinkPolicy as elements are removed.
+    //iterators are invalidated whenever the internal buffer is reallocated.
+    template<typename T, typename Alloc=std::allocator<T>, typename ShrinkPolicy=space_optimized_shrink_policy>
+    class circular_buffer_space_optimized {
+    public:
+        typedef circular_buffer<T, Alloc>                           container_type;
+        typedef circular_buffer_space_optimized<T, Alloc, ShrinkPolicy> this_type;
+        typedef ShrinkPolicy                                        shrink_policy_type;
+        typedef typename container_type::allocator_type             allocator_type;
+        typedef typename container_type::value_type                 value_type;
+        typedef typename container_type::size_type                  size_type;
+        typedef typename container_type::difference_type            difference_type;
+        typedef typename container_type::pointer                    pointer;
+        typedef typename container_type::const_pointer              const_pointer;
+        typedef typename container_type::reference                  reference;
+        typedef typename container_type::const_reference            const_reference;
+        typedef typename container_type::rvalue_type                rvalue_type;
+        typedef typename container_type::iterator                   iterator;
+        typedef typename container_type::const_iterator             const_iterator;
+        typedef typename container_type::reverse_iterator           reverse_iterator;
+        typedef typename container_type::const_reverse_iterator     const_reverse_iterator;
+        typedef typename container_type::array_range               array_range;
+        typedef typename container_type::const_array_range         const_array_range;
+        typedef typename container_type::param_value_type          param_value_type;
+    public:
+        explicit circular_buffer_space_optimized(const allocator_type & alloc = allocator_type())
+            : d_buffer(alloc),d_capacity(0),d_min_capacity(0) {
+        }
+        explicit circular_buffer_space_optimized(size_type capacity, size_type min_capacity = 0,
+                                                 const shrink_policy_type & policy = shrink_policy_type(),
+                                                 const allocator_type & alloc = allocator_type())
+            : d_buffer(alloc),d_capacity(capacity),d_min_capacity(std::min(min_capacity, capacity)),d_policy(policy) {
+            if(d_min_capacity > 0){
+                d_buffer.set_capacity(d_min_capacity);
+            }
+        }
+
+        allocator_type get_allocator() const {
+            return d_buffer.get_allocator();
+        }
+
+        iterator begin() {
+            return d_buffer.begin();
+        }
+        iterator end() {
+            return d_buffer.end();
+        }
+        const_iterator begin() const {
+            return d_buffer.begin();
+        }
+        const_iterator end() const {
+            return d_buffer.end();
+        }
+        const_iterator cbegin() const {
+            return begin();
+        }
+        const_iterator cend() const {
+            return end();
+        }
+        reverse_iterator rbegin() {
+            return d_buffer.rbegin();
+        }
+        reverse_iterator rend() {
+            return d_buffer.rend();
+        }
+        const_reverse_iterator rbegin() const {
+            return d_buffer.rbegin();
+        }
+        const_reverse_iterator rend() const{
+            return d_buffer.rend();
+        }
+        reference operator[](size_type index) {
+            return d_buffer[index];
+        }
+        const_reference operator[](size_type index) const {
+            return d_buffer[index];
+        }
+        reference at(size_type index) {
+            return d_buffer.at(index);
+        }
+        const_reference at(size_type index) const{
+            return d_buffer.at(index);
+        }
+        reference front() {
+            return d_buffer.front();
+        }
+        reference back() {
+            return d_buffer.back();
+        }
+        const_reference front() const{
+            return d_buffer.front();
+        }
+        const_reference back() const{
+            return d_buffer.back();
+        }
+        size_type size() const {
+            return d_buffer.size();
+        }
+        bool empty() const {
+            return d_buffer.empty();
+        }
+        bool full() const {
+            return size() == d_capacity;
+        }
+        size_type reserve() const {
+            return d_capacity - size();
+        }
+        size_type capacity() const {
+            return d_capacity;
+        }
+        size_type min_capacity() const {
+            return d_min_capacity;
+        }
+        //number of slots currently committed by the internal buffer
+        size_type allocated_capacity() const {
+            return d_buffer.capacity();
+        }
+        const shrink_policy_type& shrink_policy() const {
+            return d_policy;
+        }
+
+        array_range array_one() {
+            return d_buffer.array_one();
+        }
+        array_range array_two() {
+            return d_buffer.array_two();
+        }
+        const_array_range array_one() const {
+            return d_buffer.array_one();
+        }
+        const_array_range array_two() const {
+            return d_buffer.array_two();
+        }
+        bool is_linearized() const {
+            return d_buffer.is_linearized();
+        }
+        pointer linearize() {
+            return d_buffer.linearize();
+        }
+
+        void set_capacity(size_type capacity, size_type min_capacity = 0){
+            d_capacity = capacity;
+            d_min_capacity = std::min(min_capacity, capacity);
+            size_type allocated = std::max(std::min(size(), d_capacity), d_min_capacity);
+            if(allocated != d_buffer.capacity()){
+                reallocate(allocated);
+            }
+        }
+        void shrink_to_fit(){
+            size_type allocated = std::max(size(), d_min_capacity);
+            if(allocated < d_buffer.capacity()){
+                reallocate(allocated);
+            }
+        }
+        void resize(size_type __size, param_value_type value = value_type()){
+            if(__size < size()){
+                erase_end(size() - __size);
+            }else if(__size > size()){
+                insert(end(), __size - size(), value);
+            }
+        }
+
+        void swap(circular_buffer_space_optimized<T, Alloc, ShrinkPolicy> & other) noexcept{
+            d_buffer.swap(other.d_buffer);
+            std::swap(d_capacity,other.d_capacity);
+            std::swap(d_min_capacity,other.d_min_capacity);
+            std::swap(d_policy,other.d_policy);
+        }
+        //false only when capacity() is 0, as for circular_buffer
+        bool push_back(param_value_type value) {
+            grow(1);
+            return d_buffer.push_back(value);
+        }
+        bool push_back(rvalue_type rvalue) {
+            grow(1);
+            return d_buffer.push_back(std::move(rvalue));
+        }
+        template <typename ... Args>
+        bool emplace_back(Args&& ... args){
+            grow(1);
+            return d_buffer.emplace_back(std::forward<Args>(args)...);
+        }
+        template<typename InputIterator>
+        size_type push_back(InputIterator first, InputIterator last){
+            grow(std::distance(first, last));
+            return d_buffer.push_back(first, last);
+        }
+        bool push_front(param_value_type value){
+            grow(1);
+            return d_buffer.push_front(value);
+        }
+        bool push_front(rvalue_type rvalue){
+            grow(1);
+            return d_buffer.push_front(std::move(rvalue));
+        }
+        template <typename ... Args>
+        bool emplace_front(Args&& ... args){
+            grow(1);
+            return d_buffer.emplace_front(std::forward<Args>(args)...);
+        }
+
+        void pop_back(){
+            d_buffer.pop_back();
+            shrink();
+        }
+        void pop_front(){
+            d_buffer.pop_front();
+            shrink();
+        }
+        template<typename OutputIterator>
+        size_type pop_front(OutputIterator out, size_type n){
+            n = d_buffer.pop_front(out, n);
+            shrink();
+            return n;
+        }
+
+        iterator insert(iterator pos, param_value_type value){
+            difference_type index = grow(pos, 1);
+            d_buffer.insert(begin() + index, value);
+            return begin() + index;
+        }
+        iterator insert(iterator pos, rvalue_type rvalue){
+            difference_type index = grow(pos, 1);
+            d_buffer.insert(begin() + index, std::move(rvalue));
+            return begin() + index;
+        }
+        void insert(iterator pos, size_type n, param_value_type value){
+            difference_type index = grow(pos, n);
+            d_buffer.insert(begin() + index, n, value);
+        }
+        template<typename InputIterator>
+        void insert(iterator pos, InputIterator __begin, InputIterator __end){
+            difference_type index = grow(pos, std::distance(__begin, __end));
+            d_buffer.insert(begin() + index, __begin, __end);
+        }
+
+        iterator erase(iterator pos){
+            return erase(pos,pos+1);
+        }
+        iterator erase(iterator __begin, iterator __end){
+            difference_type index = __begin - begin();
+            d_buffer.erase(__begin, __end);
+            shrink();
+            return begin() + index;
+        }
+        void erase_begin(size_type n){
+            d_buffer.erase_begin(n);
+            shrink();
+        }
+        void erase_end(size_type n){
+            d_buffer.erase_end(n);
+            shrink();
+        }
+        void clear() {
+            d_buffer.clear();
+            shrink();
+        }
+    private:
+        //make room for n more elements, doubling the committed storage up to capacity()
+        void grow(size_type n){
+            size_type allocated = d_buffer.capacity();
+            size_type needed = std::min(size() + n, d_capacity);
+            if(needed > allocated){
+                reallocate(std::min(d_capacity, std::max(needed, std::max(allocated * 2, d_min_capacity))));
+            }
+        }
+        difference_type grow(iterator pos, size_type n){
+            difference_type index = pos - begin();
+            grow(n);
+            return index;
+        }
+        void shrink(){
+            size_type allocated = d_buffer.capacity();
+            size_type target = std::max(d_policy.shrink_to(size(), allocated), std::max(size(), d_min_capacity));
+            if(target < allocated){
+                reallocate(target);
+            }
+        }
+        void reallocate(size_type allocated){
+            if(allocated == 0){
+                container_type(d_buffer.get_allocator()).swap(d_buffer);
+            }else{
+                d_buffer.set_capacity(allocated);
+            }
+        }
+    private:
+        container_type      d_buffer;
+        size_type           d_capacity;
+        size_type           d_min_capacity;
+        shrink_policy_type  d_policy;
+    };
+}
+#endif
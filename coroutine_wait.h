@@ -0,0 +1,114 @@
+#ifndef COROUTINE_WAIT_H_
+#define COROUTINE_WAIT_H_
+
+//GL_HAS_COROUTINES is 1 when the compiler provides C++20 coroutines
+#if __cplusplus >= 202002L && defined(__has_include)
+#if __has_include(<coroutine>)
+#define GL_HAS_COROUTINES 1
+#endif
+#endif
+#ifndef GL_HAS_COROUTINES
+#define GL_HAS_COROUTINES 0
+#endif
+
+#if GL_HAS_COROUTINES
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+#include <coroutine>
+
+namespace gl {
+    //resumes a coroutine on the thread that completed its operation
+    struct inline_executor {
+        void operator()(std::coroutine_handle<> handle) const {
+            handle.resume();
+        }
+    };
+
+    //a suspended coroutine waiting for an operation. ready() attempts the operation, the same
+    //predicate a wait strategy polls; resume() hands the coroutine to its executor
+    class _coroutine_waiter {
+    public:
+        virtual bool ready() = 0;
+        virtual void resume() = 0;
+    protected:
+        ~_coroutine_waiter() = default;
+    public:
+        _coroutine_waiter*  next = nullptr;
+    };
+
+    //FIFO of suspended coroutines, the coroutine counterpart of a wait strategy.
+    //instead of waking a waiter to retry, notify runs the oldest waiter's operation on the notifying
+    //thread and resumes it only once the operation succeeded, so a resumed coroutine never has to
+    //suspend again. the list lock is held while registering and while running operations, never
+    //while a coroutine is suspended or being resumed
+    class coroutine_wait_list {
+    public:
+        coroutine_wait_list() : d_waiters(0) {
+        }
+        coroutine_wait_list(const coroutine_wait_list&) = delete;
+        coroutine_wait_list& operator=(const coroutine_wait_list&) = delete;
+
+        //returns false if the operation succeeded right away and the caller must not suspend.
+        //once it returns true the waiter may already be resumed on another thread
+        bool suspend(_coroutine_waiter* waiter){
+            std::lock_guard<std::mutex> lock(d_mutex);
+            d_waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(d_head == nullptr && waiter->ready()){
+                d_waiters.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+            waiter->next = nullptr;
+            if(d_head == nullptr){
+                d_head = waiter;
+            }else{
+                d_tail->next = waiter;
+            }
+            d_tail = waiter;
+            return true;
+        }
+        void notify_one(){
+            notify(1);
+        }
+        void notify_all(){
+            notify(static_cast<std::size_t>(-1));
+        }
+        void notify_n(std::size_t n){
+            notify(n);
+        }
+    private:
+        //completes up to n waiters in order, stopping at the first whose operation fails
+        void notify(std::size_t n){
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(d_waiters.load(std::memory_order_relaxed) == 0){
+                return;
+            }
+            _coroutine_waiter* done = nullptr;
+            _coroutine_waiter** done_tail = &done;
+            {
+                std::lock_guard<std::mutex> lock(d_mutex);
+                for(; n != 0 && d_head != nullptr && d_head->ready(); --n){
+                    _coroutine_waiter* waiter = d_head;
+                    d_head = waiter->next;
+                    waiter->next = nullptr;
+                    *done_tail = waiter;
+                    done_tail = &waiter->next;
+                    d_waiters.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+            while(done != nullptr){
+                _coroutine_waiter* waiter = done;
+                done = waiter->next;
+                waiter->resume();
+            }
+        }
+    private:
+        std::atomic<int>        d_waiters;
+        std::mutex              d_mutex;
+        _coroutine_waiter*      d_head = nullptr;
+        _coroutine_waiter*      d_tail = nullptr;
+    };
+}
+#endif
+#endif
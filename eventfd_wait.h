@@ -0,0 +1,152 @@
+#ifndef EVENTFD_WAIT_H_
+#define EVENTFD_WAIT_H_
+
+#if !defined(__linux__)
+#error "eventfd_wait requires Linux eventfd"
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <system_error>
+#include <cerrno>
+#include <cstdint>
+#include <cstddef>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+
+namespace gl {
+    //wait strategy that signals through an eventfd, so a consumer can register native_handle()
+    //in its own epoll/poll loop next to sockets and timers instead of blocking in the queue.
+    //notifications coalesce: the first notify after a drain() writes the eventfd once and later
+    //ones are a single atomic exchange until the descriptor is drained again. a consumer drains
+    //only when it found nothing left to take and then looks once more, so pushes arriving while
+    //it is still busy do not write the descriptor at all.
+    //threads can also wait() on it directly, it then polls the descriptor itself. a drain can
+    //swallow notifications meant for other waiting threads, so a thread that drained passes
+    //the notification on when it stops waiting, if any other thread is still waiting.
+    //the descriptor is created on first use, so a strategy nobody waits on costs no descriptor.
+    //notifications sent before then went nowhere, so it is created readable: the first poll of a
+    //new descriptor always returns and its owner looks at the queue before waiting
+    class eventfd_wait {
+    public:
+        eventfd_wait() : d_fd(-1),d_pending(false),d_waiters(0) {
+        }
+        eventfd_wait(const eventfd_wait&) = delete;
+        eventfd_wait& operator=(const eventfd_wait&) = delete;
+        ~eventfd_wait() noexcept {
+            int fd = d_fd.load(std::memory_order_relaxed);
+            if(fd >= 0){
+                ::close(fd);
+            }
+        }
+        //readable while a notification is pending
+        int native_handle() const {
+            int fd = d_fd.load(std::memory_order_acquire);
+            return fd >= 0 ? fd : open();
+        }
+        //clears a pending notification, the following notify writes the descriptor again
+        void drain(){
+            int fd = native_handle();
+            std::uint64_t count;
+            while(::read(fd, &count, sizeof(count)) < 0 && errno == EINTR){
+            }
+            //acquires what the notifier published before it set the flag
+            d_pending.exchange(false, std::memory_order_acq_rel);
+        }
+
+        template<typename Predicate>
+        void wait(Predicate ready){
+            if(ready()){
+                return;
+            }
+            enter();
+            while(!ready()){
+                poll(-1);
+                drain();
+            }
+            leave();
+        }
+        template<typename Predicate, typename Clock, typename Duration>
+        bool wait_until(Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline){
+            if(ready()){
+                return true;
+            }
+            enter();
+            bool result;
+            for(;;){
+                if(ready()){
+                    result = true;
+                    break;
+                }
+                typename Clock::time_point now = Clock::now();
+                if(now >= deadline){
+                    result = false;
+                    break;
+                }
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+                poll(ms > 0x7fffffff ? 0x7fffffff : static_cast<int>(ms));
+                drain();
+            }
+            leave();
+            return result;
+        }
+        void notify_one(){
+            notify();
+        }
+        void notify_all(){
+            notify();
+        }
+        void notify_n(std::size_t){
+            notify();
+        }
+    private:
+        void notify(){
+            //no descriptor yet: it is created readable, so this notification is not needed
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int fd = d_fd.load(std::memory_order_relaxed);
+            if(fd < 0 || d_pending.exchange(true, std::memory_order_acq_rel)){
+                return;
+            }
+            std::uint64_t one = 1;
+            while(::write(fd, &one, sizeof(one)) < 0 && errno == EINTR){
+            }
+        }
+        void enter(){
+            native_handle();
+            d_waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        void leave(){
+            if(d_waiters.fetch_sub(1, std::memory_order_acq_rel) != 1){
+                notify();
+            }
+        }
+        int open() const {
+            int fd = ::eventfd(1, EFD_NONBLOCK | EFD_CLOEXEC);
+            if(fd < 0){
+                throw std::system_error(errno, std::system_category(), "eventfd");
+            }
+            int expected = -1;
+            if(!d_fd.compare_exchange_strong(expected, fd, std::memory_order_seq_cst)){
+                ::close(fd);
+                return expected;
+            }
+            //pairs with the fence in notify(): a notifier that saw no descriptor pushed before this
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return fd;
+        }
+        void poll(int timeout_ms){
+            pollfd p;
+            p.fd = d_fd.load(std::memory_order_relaxed);
+            p.events = POLLIN;
+            p.revents = 0;
+            ::poll(&p, 1, timeout_ms);
+        }
+    private:
+        mutable std::atomic<int>    d_fd;
+        std::atomic<bool>           d_pending;
+        std::atomic<int>            d_waiters;
+    };
+}
+#endif
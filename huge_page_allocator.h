@@ -0,0 +1,169 @@
+#ifndef HUGE_PAGE_ALLOCATOR_H_
+#define HUGE_PAGE_ALLOCATOR_H_
+
+#if !defined(__linux__)
+#error "huge_page_allocator requires Linux mmap, madvise and mbind"
+#endif
+
+#include<new>
+#include<cstddef>
+#include<cerrno>
+#include<vector>
+#include<sys/mman.h>
+#include<sys/syscall.h>
+#include<unistd.h>
+#include<linux/mempolicy.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+namespace gl {
+    enum huge_page_mode {
+        huge_page_none,         //regular pages
+        huge_page_transparent,  //2MB aligned mapping advised with MADV_HUGEPAGE
+        huge_page_explicit      //MAP_HUGETLB from the reserved pool, transparent if the pool is empty
+    };
+    //numa_node value placing each page on the node of the thread that first touches it
+    const int numa_first_touch = -1;
+    const std::size_t default_huge_page_size = 2 * 1024 * 1024;
+
+    //by default only allocations of at least a huge page get their own mapping
+    struct huge_page_options {
+        huge_page_options(huge_page_mode mode_ = huge_page_transparent, int numa_node_ = numa_first_touch,
+                          bool prefault_ = false, std::size_t min_bytes_ = default_huge_page_size)
+            : mode(mode_),numa_node(numa_node_),prefault(prefault_),min_bytes(min_bytes_),huge_page_size(default_huge_page_size) {
+        }
+        huge_page_mode  mode;
+        int             numa_node;      //node to bind the storage to, or numa_first_touch
+        bool            prefault;       //touch every page in allocate() so no fault is taken on the hot path
+        std::size_t     min_bytes;      //smaller allocations come from operator new
+        std::size_t     huge_page_size;
+    };
+    inline bool operator==(const huge_page_options& left, const huge_page_options& right) {
+        return left.mode == right.mode && left.numa_node == right.numa_node && left.prefault == right.prefault
+            && left.min_bytes == right.min_bytes && left.huge_page_size == right.huge_page_size;
+    }
+    inline bool operator!=(const huge_page_options& left, const huge_page_options& right) {
+        return !(left == right);
+    }
+
+    //allocator for large circular_buffer/sync_deque storage: each allocation is its own mapping,
+    //optionally backed by huge pages, bound to a NUMA node and prefaulted
+    template<typename T>
+    class huge_page_allocator {
+    public:
+        typedef T               value_type;
+        typedef T*              pointer;
+        typedef const T*        const_pointer;
+        typedef std::size_t     size_type;
+        typedef std::ptrdiff_t  difference_type;
+        template<typename U>
+        struct rebind {
+            typedef huge_page_allocator<U> other;
+        };
+    public:
+        huge_page_allocator(const huge_page_options& options = huge_page_options()) noexcept
+            : d_options(options) {
+        }
+        template<typename U>
+        huge_page_allocator(const huge_page_allocator<U>& other) noexcept
+            : d_options(other.options()) {
+        }
+        const huge_page_options& options() const noexcept {
+            return d_options;
+        }
+        pointer allocate(size_type n) {
+            std::size_t bytes = n * sizeof(value_type);
+            if(bytes < d_options.min_bytes){
+                return static_cast<pointer>(::operator new(bytes));
+            }
+            std::size_t length = mapping_length(bytes);
+            void* p = MAP_FAILED;
+            if(d_options.mode == huge_page_explicit){
+                p = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_page_size_flags(), -1, 0);
+            }
+            //a hugetlb page is faulted in whole. a transparent one may be refused and fall back
+            //to regular pages, so those are touched one by one; touches inside a huge page fault nothing
+            std::size_t page = d_options.huge_page_size;
+            if(p == MAP_FAILED){
+                p = map_aligned(length);
+                page = ::sysconf(_SC_PAGESIZE);
+            }
+            bind(p, length);
+            if(d_options.prefault){
+                for(std::size_t offset = 0; offset < length; offset += page){
+                    static_cast<volatile char*>(p)[offset] = 0;
+                }
+            }
+            return static_cast<pointer>(p);
+        }
+        void deallocate(pointer p, size_type n) noexcept {
+            std::size_t bytes = n * sizeof(value_type);
+            if(bytes < d_options.min_bytes){
+                ::operator delete(p);
+            }else{
+                ::munmap(p, mapping_length(bytes));
+            }
+        }
+    private:
+        std::size_t mapping_length(std::size_t bytes) const {
+            std::size_t unit = d_options.mode == huge_page_none ? (std::size_t)::sysconf(_SC_PAGESIZE) : d_options.huge_page_size;
+            return (bytes + unit - 1) / unit * unit;
+        }
+        //MAP_HUGETLB takes the pool's page size as log2 in the MAP_HUGE_* bits, 0 selects the default pool
+        int huge_page_size_flags() const {
+            int shift = 0;
+            while((std::size_t(1) << shift) < d_options.huge_page_size){
+                ++shift;
+            }
+            return (std::size_t(1) << shift) == d_options.huge_page_size ? shift << MAP_HUGE_SHIFT : 0;
+        }
+        //huge pages can only back huge page aligned ranges, so over-map and trim both ends
+        void* map_aligned(std::size_t length) const {
+            std::size_t align = d_options.mode == huge_page_none ? 0 : d_options.huge_page_size;
+            void* p = ::mmap(nullptr, length + align, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(p == MAP_FAILED){
+                throw std::bad_alloc();
+            }
+            if(align == 0){
+                return p;
+            }
+            char* base = static_cast<char*>(p);
+            char* aligned = reinterpret_cast<char*>((reinterpret_cast<std::size_t>(base) + align - 1) / align * align);
+            if(aligned != base){
+                ::munmap(base, aligned - base);
+            }
+            if(aligned + length != base + length + align){
+                ::munmap(aligned + length, (base + length + align) - (aligned + length));
+            }
+            ::madvise(aligned, length, MADV_HUGEPAGE);
+            return aligned;
+        }
+        void bind(void* p, std::size_t length) const {
+            if(d_options.numa_node == numa_first_touch){
+                ::syscall(SYS_mbind, p, length, MPOL_LOCAL, nullptr, 0, 0);
+                return;
+            }
+            const std::size_t bits = sizeof(unsigned long) * 8;
+            std::vector<unsigned long> mask(d_options.numa_node / bits + 1, 0);
+            mask[d_options.numa_node / bits] = 1UL << (d_options.numa_node % bits);
+            //allocate() reports every failure as std::bad_alloc, like operator new
+            if(::syscall(SYS_mbind, p, length, MPOL_BIND, mask.data(), mask.size() * bits + 1, 0) != 0 && errno != ENOSYS){
+                ::munmap(p, length);
+                throw std::bad_alloc();
+            }
+        }
+    private:
+        huge_page_options d_options;
+    };
+    template<typename T, typename U>
+    bool operator==(const huge_page_allocator<T>& left, const huge_page_allocator<U>& right) {
+        return left.options() == right.options();
+    }
+    template<typename T, typename U>
+    bool operator!=(const huge_page_allocator<T>& left, const huge_page_allocator<U>& right) {
+        return !(left == right);
+    }
+}
+#endif
@@ -0,0 +1,176 @@
+#ifndef MESSAGE_RING_H_
+#define MESSAGE_RING_H_
+
+#include "cache_line.h"
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <stdexcept>
+#include <cstring>
+#include <cassert>
+#include <cstdint>
+
+namespace gl {
+    //ring of variable-length byte records for one producer thread and one consumer thread.
+    //the producer reserve()s a contiguous region, writes the record in place and commit()s it;
+    //the consumer peek()s the oldest record in place and release()s it, so a record is never copied
+    //by the ring. every record is stored as an 8 byte header holding its length followed by the
+    //bytes, rounded up to 8 bytes. a record never wraps: when it does not fit before the end of the
+    //storage the rest of the lap is marked as padding, which the consumer skips.
+    //indexes and cached copies are laid out as in spsc_queue
+    template<typename Alloc=std::allocator<char>>
+    class message_ring {
+    public:
+        typedef message_ring<Alloc>                     this_type;
+        typedef Alloc                                   allocator_type;
+        typedef std::size_t                             size_type;
+        typedef char*                                   pointer;
+        typedef const char*                             const_pointer;
+        typedef std::pair<pointer, size_type>           array_range;
+        typedef std::pair<const_pointer, size_type>     const_array_range;
+
+        static const size_type record_alignment = 8;
+    private:
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<std::uint64_t> word_allocator_type;
+        typedef std::allocator_traits<word_allocator_type>                                  word_alloc_traits;
+
+        static const std::uint32_t padding_length = 0xffffffffu;
+        static const size_type no_reservation = size_type(-1);
+        struct header {
+            std::uint32_t   length;
+            std::uint32_t   reserved;
+        };
+    public:
+        //capacity in bytes, including headers and padding, is rounded up to a power of two
+        explicit message_ring(size_type capacity, const allocator_type & alloc = allocator_type())
+            : d_tail(0),d_head_cache(0),d_reserved(0),d_reserved_size(no_reservation),d_head(0),d_tail_cache(0),d_alloc(alloc) {
+            d_capacity = sizeof(header) * 2;
+            while(d_capacity < capacity){
+                d_capacity <<= 1;
+            }
+            d_data = reinterpret_cast<char*>(word_alloc_traits::allocate(d_alloc, d_capacity / sizeof(std::uint64_t)));
+        }
+        message_ring(const message_ring&) = delete;
+        message_ring& operator=(const message_ring&) = delete;
+        ~message_ring() noexcept {
+            word_alloc_traits::deallocate(d_alloc, reinterpret_cast<std::uint64_t*>(d_data), d_capacity / sizeof(std::uint64_t));
+        }
+
+        //producer side. returns n contiguous writable bytes, or nullptr if there is no room now.
+        //the region stays reserved until commit() or the next reserve(); throws std::length_error
+        //if n is more than max_record_size(). a record may have to skip the rest of a lap, so only
+        //records of up to half the ring are guaranteed to fit once it is empty
+        pointer reserve(size_type n){
+            if(n > max_record_size() || n >= padding_length){
+                throw std::length_error("message_ring record larger than the ring");
+            }
+            size_type need = record_size(n);
+            size_type tail = d_tail.load(std::memory_order_relaxed);
+            size_type offset = tail & (d_capacity - 1);
+            size_type pad = d_capacity - offset < need ? d_capacity - offset : 0;
+            if(!has_room(tail, pad + need)){
+                return nullptr;
+            }
+            if(pad != 0){
+                header_at(offset)->length = padding_length;
+                offset = 0;
+            }
+            d_reserved = tail + pad;
+            d_reserved_size = n;
+            return d_data + offset + sizeof(header);
+        }
+        //publishes the reserved record holding its first n bytes, n at most what was reserved
+        void commit(size_type n){
+            assert(d_reserved_size != no_reservation && "message_ring::commit without reserve");
+            assert(n <= d_reserved_size && "message_ring::commit of more than was reserved");
+            d_reserved_size = no_reservation;
+            header_at(d_reserved & (d_capacity - 1))->length = static_cast<std::uint32_t>(n);
+            d_tail.store(d_reserved + record_size(n), std::memory_order_release);
+        }
+        //copies a whole record in, returns false if there is no room
+        bool try_write(const void* data, size_type n){
+            pointer p = reserve(n);
+            if(p == nullptr){
+                return false;
+            }
+            std::memcpy(p, data, n);
+            commit(n);
+            return true;
+        }
+
+        //consumer side. the oldest record, or {nullptr,0} if the ring is empty.
+        //it stays valid and in place until release()
+        const_array_range peek(){
+            size_type head = d_head.load(std::memory_order_relaxed);
+            for(;;){
+                if(head == d_tail_cache){
+                    d_tail_cache = d_tail.load(std::memory_order_acquire);
+                    if(head == d_tail_cache){
+                        return const_array_range(nullptr, 0);
+                    }
+                }
+                size_type offset = head & (d_capacity - 1);
+                const header* h = header_at(offset);
+                if(h->length != padding_length){
+                    return const_array_range(d_data + offset + sizeof(header), h->length);
+                }
+                head += d_capacity - offset;
+                d_head.store(head, std::memory_order_release);
+            }
+        }
+        //drops the record returned by the last peek()
+        void release(){
+            size_type head = d_head.load(std::memory_order_relaxed);
+            const header* h = header_at(head & (d_capacity - 1));
+            d_head.store(head + record_size(h->length), std::memory_order_release);
+        }
+
+        //bytes in use, including headers and padding. approximate while the other side is running
+        size_type size() const {
+            return d_tail.load(std::memory_order_acquire) - d_head.load(std::memory_order_acquire);
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        size_type capacity() const {
+            return d_capacity;
+        }
+        //the largest record reserve() accepts, it always fits once the ring is empty
+        size_type max_record_size() const {
+            return d_capacity / 2 - sizeof(header);
+        }
+    private:
+        static size_type record_size(size_type n){
+            return (sizeof(header) + n + record_alignment - 1) & ~(record_alignment - 1);
+        }
+        header* header_at(size_type offset) const {
+            return reinterpret_cast<header*>(d_data + offset);
+        }
+        bool has_room(size_type tail, size_type n){
+            if(tail + n - d_head_cache <= d_capacity){
+                return true;
+            }
+            d_head_cache = d_head.load(std::memory_order_acquire);
+            return tail + n - d_head_cache <= d_capacity;
+        }
+    private:
+        //producer's line
+        _cache_line_pad                                 d_pad0;
+        std::atomic<size_type>                          d_tail;
+        size_type                                       d_head_cache;
+        size_type                                       d_reserved;
+        size_type                                       d_reserved_size;
+        //consumer's line
+        _cache_line_pad                                 d_pad1;
+        std::atomic<size_type>                          d_head;
+        size_type                                       d_tail_cache;
+        _cache_line_pad                                 d_pad2;
+        char*                                           d_data;
+        size_type                                       d_capacity;
+        word_allocator_type                             d_alloc;
+    };
+
+    template<typename Alloc>
+    const typename message_ring<Alloc>::size_type message_ring<Alloc>::record_alignment;
+}
+#endif
@@ -0,0 +1,320 @@
+#ifndef MIRRORED_RING_BUFFER_H_
+#define MIRRORED_RING_BUFFER_H_
+
+#if !defined(__linux__)
+#error "mirrored_ring_buffer requires Linux memfd_create and mmap"
+#endif
+
+#include<stdexcept>
+#include<system_error>
+#include<iterator>
+#include<algorithm>
+#include<utility>
+#include<type_traits>
+#include<cstring>
+#include<cassert>
+#include<cerrno>
+#include<sys/mman.h>
+#include<unistd.h>
+
+namespace gl {
+    //ring of trivially copyable elements whose storage is mapped twice back to back,
+    //so the slot after the last one is the first one again. any run of up to capacity()
+    //elements is contiguous in memory: begin()/end() are plain pointers and there is
+    //never a wrap point for readers, parsers or read()/recv() to handle.
+    //capacity is rounded up so the storage is a whole number of pages.
+    template<typename T>
+    class mirrored_ring_buffer {
+        static_assert(std::is_trivially_copyable<T>::value, "mirrored_ring_buffer requires a trivially copyable type");
+    public:
+        typedef mirrored_ring_buffer<T>                 this_type;
+        typedef T                                       value_type;
+        typedef std::size_t                             size_type;
+        typedef std::ptrdiff_t                          difference_type;
+        typedef T*                                      pointer;
+        typedef const T*                                const_pointer;
+        typedef T&                                      reference;
+        typedef const T&                                const_reference;
+        typedef pointer                                 iterator;
+        typedef const_pointer                           const_iterator;
+        typedef std::reverse_iterator<iterator>         reverse_iterator;
+        typedef std::reverse_iterator<const_iterator>   const_reverse_iterator;
+        typedef std::pair<pointer, size_type>           array_range;
+        typedef std::pair<const_pointer, size_type>     const_array_range;
+
+        typedef const value_type& param_value_type;
+    public:
+        mirrored_ring_buffer() noexcept
+            : d_data(nullptr),d_capacity(0),d_first(0),d_size(0){
+        }
+        explicit mirrored_ring_buffer(size_type capacity)
+            : d_data(nullptr),d_capacity(0),d_first(0),d_size(0){
+            init(capacity);
+        }
+        mirrored_ring_buffer(const mirrored_ring_buffer&) = delete;
+        mirrored_ring_buffer& operator=(const mirrored_ring_buffer&) = delete;
+        mirrored_ring_buffer(mirrored_ring_buffer&& other) noexcept
+            : d_data(other.d_data),d_capacity(other.d_capacity),d_first(other.d_first),d_size(other.d_size){
+            other.d_data = nullptr;
+            other.d_capacity = 0;
+            other.d_first = 0;
+            other.d_size = 0;
+        }
+        mirrored_ring_buffer& operator=(mirrored_ring_buffer&& other) noexcept {
+            this_type temp(std::move(other));
+            swap(temp);
+            return *this;
+        }
+        ~mirrored_ring_buffer() noexcept {
+            if(d_data){
+                ::munmap(d_data, 2 * d_capacity * sizeof(value_type));
+            }
+        }
+
+        iterator begin() {
+            return d_data + d_first;
+        }
+        iterator end() {
+            return d_data + d_first + d_size;
+        }
+        const_iterator begin() const {
+            return d_data + d_first;
+        }
+        const_iterator end() const {
+            return d_data + d_first + d_size;
+        }
+        const_iterator cbegin() const {
+            return begin();
+        }
+        const_iterator cend() const {
+            return end();
+        }
+        reverse_iterator rbegin() {
+            return reverse_iterator(end());
+        }
+        reverse_iterator rend() {
+            return reverse_iterator(begin());
+        }
+        const_reverse_iterator rbegin() const {
+            return const_reverse_iterator(end());
+        }
+        const_reverse_iterator rend() const{
+            return const_reverse_iterator(begin());
+        }
+        pointer data() {
+            return begin();
+        }
+        const_pointer data() const {
+            return begin();
+        }
+        reference operator[](size_type index) {
+            return begin()[index];
+        }
+        const_reference operator[](size_type index) const {
+            return begin()[index];
+        }
+        reference at(size_type index) {
+            if(index >= size()){
+                throw std::out_of_range("mirrored_ring_buffer index is out of range");
+            }
+            return (*this)[index];
+        }
+        const_reference at(size_type index) const{
+            if(index >= size()){
+                throw std::out_of_range("mirrored_ring_buffer index is out of range");
+            }
+            return (*this)[index];
+        }
+        reference front() {
+            return *begin();
+        }
+        reference back() {
+            return *(end() - 1);
+        }
+        const_reference front() const{
+            return *begin();
+        }
+        const_reference back() const{
+            return *(end() - 1);
+        }
+        size_type size() const {
+            return d_size;
+        }
+        bool empty() const {
+            return d_size == 0;
+        }
+        bool full() const {
+            return d_size == d_capacity;
+        }
+        size_type reserve() const {
+            return d_capacity - d_size;
+        }
+        size_type capacity() const {
+            return d_capacity;
+        }
+
+        array_range array_one() {
+            return array_range(begin(), d_size);
+        }
+        array_range array_two() {
+            return array_range(end(), 0);
+        }
+        const_array_range array_one() const {
+            return const_array_range(begin(), d_size);
+        }
+        const_array_range array_two() const {
+            return const_array_range(end(), 0);
+        }
+        bool is_linearized() const {
+            return true;
+        }
+        pointer linearize() {
+            return begin();
+        }
+
+        //contiguous free space after the last element, for read()/recv() to fill before commit()
+        array_range prepare() {
+            return array_range(end(), reserve());
+        }
+        //appends the first n elements written to prepare()'s range, n at most its size
+        void commit(size_type n) {
+            assert(n <= reserve() && "mirrored_ring_buffer::commit of more than prepare() returned");
+            d_size += n;
+        }
+        void consume(size_type n) {
+            assert(n <= size() && "mirrored_ring_buffer::consume of more than size()");
+            erase_begin(n);
+        }
+
+        void swap(mirrored_ring_buffer<T> & other) noexcept{
+            std::swap(d_data,other.d_data);
+            std::swap(d_capacity,other.d_capacity);
+            std::swap(d_first,other.d_first);
+            std::swap(d_size,other.d_size);
+        }
+        void push_back(param_value_type value) {
+            if(capacity()==0){
+                return;
+            }
+            if(full()){
+                pop_front();
+            }
+            *end() = value;
+            ++d_size;
+        }
+        template <typename ... Args>
+        void emplace_back(Args&& ... args){
+            push_back(value_type(std::forward<Args>(args)...));
+        }
+        template<typename InputIterator>
+        void push_back(InputIterator first, InputIterator last){
+            if(capacity()==0){
+                return;
+            }
+            size_type n = std::distance(first, last);
+            if(n >= capacity()){
+                clear();
+                std::advance(first, n - capacity());
+                n = capacity();
+            }else if(n > reserve()){
+                erase_begin(n - reserve());
+            }
+            std::copy(first, last, end());
+            d_size += n;
+        }
+        void push_front(param_value_type value){
+            if(capacity()==0){
+                return;
+            }
+            if(full()){
+                pop_back();
+            }
+            d_first = (d_first == 0 ? d_capacity : d_first) - 1;
+            *begin() = value;
+            ++d_size;
+        }
+        template <typename ... Args>
+        void emplace_front(Args&& ... args){
+            push_front(value_type(std::forward<Args>(args)...));
+        }
+
+        void pop_back(){
+            --d_size;
+        }
+        void pop_front(){
+            erase_begin(1);
+        }
+        template<typename OutputIterator>
+        size_type pop_front(OutputIterator out, size_type n){
+            n = std::min(n, size());
+            std::copy(begin(), begin() + n, out);
+            erase_begin(n);
+            return n;
+        }
+        void erase_begin(size_type n){
+            d_first += n;
+            if(d_first >= d_capacity){
+                d_first -= d_capacity;
+            }
+            d_size -= n;
+        }
+        void erase_end(size_type n){
+            d_size -= n;
+        }
+        void clear() {
+            d_first = 0;
+            d_size = 0;
+        }
+    private:
+        static size_type gcd(size_type a, size_type b){
+            while(b != 0){
+                size_type t = a % b;
+                a = b;
+                b = t;
+            }
+            return a;
+        }
+        void init(size_type capacity){
+            if(capacity == 0){
+                return;
+            }
+            //the mapping must be a whole number of pages and of elements
+            size_type page = ::sysconf(_SC_PAGESIZE);
+            size_type unit = page / gcd(page, sizeof(value_type)) * sizeof(value_type);
+            size_type bytes = (capacity * sizeof(value_type) + unit - 1) / unit * unit;
+            int fd = ::memfd_create("gl_mirrored_ring_buffer", MFD_CLOEXEC);
+            if(fd < 0){
+                throw std::system_error(errno, std::system_category(), "mirrored_ring_buffer memfd_create failed");
+            }
+            if(::ftruncate(fd, bytes) != 0){
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::system_category(), "mirrored_ring_buffer ftruncate failed");
+            }
+            //reserve twice the size, then map the same file over both halves
+            void* base = ::mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(base == MAP_FAILED){
+                int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::system_category(), "mirrored_ring_buffer mmap failed");
+            }
+            char* first = static_cast<char*>(base);
+            if(::mmap(first, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED
+               || ::mmap(first + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED){
+                int error = errno;
+                ::munmap(base, 2 * bytes);
+                ::close(fd);
+                throw std::system_error(error, std::system_category(), "mirrored_ring_buffer mmap failed");
+            }
+            ::close(fd);
+            d_data = reinterpret_cast<pointer>(base);
+            d_capacity = bytes / sizeof(value_type);
+        }
+    private:
+        pointer     d_data;
+        size_type   d_capacity;
+        size_type   d_first;
+        size_type   d_size;
+    };
+}
+#endif
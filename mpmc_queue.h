@@ -0,0 +1,203 @@
+#ifndef MPMC_QUEUE_H_
+#define MPMC_QUEUE_H_
+
+#include "cache_line.h"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+namespace gl {
+    template<typename T>
+    struct _mpmc_queue_cell {
+        std::atomic<std::size_t>                                    sequence;
+        std::atomic<bool>                                           cancelled;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type  storage;
+    };
+
+    //bounded lock-free queue for any number of producers and consumers.
+    //every cell carries a sequence number telling whether it is free or holds an element for
+    //the current lap, so producers and consumers only contend on their own position counter
+    //and never on a lock; an operation retries only when another thread claimed the same cell.
+    //the capacity is at least 2, capacity() reports the one in effect
+    template<typename T, typename Alloc=std::allocator<T>>
+    class mpmc_queue {
+    public:
+        typedef mpmc_queue<T, Alloc>                    this_type;
+        typedef Alloc                                   allocator_type;
+        typedef std::allocator_traits<allocator_type>   alloc_traits;
+        typedef typename alloc_traits::value_type       value_type;
+        typedef typename alloc_traits::size_type        size_type;
+        typedef value_type*                             pointer;
+        typedef value_type&                             reference;
+        typedef T&&                                     rvalue_type;
+
+        typedef const value_type& param_value_type;
+    private:
+        typedef _mpmc_queue_cell<value_type>                                cell_type;
+        typedef typename alloc_traits::template rebind_alloc<cell_type>     cell_allocator_type;
+        typedef std::allocator_traits<cell_allocator_type>                  cell_alloc_traits;
+    public:
+        //with a single cell a full cell would look free to the next lap, so capacity is at least 2
+        explicit mpmc_queue(size_type capacity, const allocator_type & alloc = allocator_type())
+            : d_enqueue_pos(0),d_dequeue_pos(0),d_capacity(capacity < 2 ? 2 : capacity),d_alloc(alloc),d_cell_alloc(alloc) {
+            d_cells = cell_alloc_traits::allocate(d_cell_alloc, d_capacity);
+            for(size_type i = 0; i < d_capacity; ++i){
+                ::new(static_cast<void*>(&d_cells[i].sequence)) std::atomic<std::size_t>(i);
+                ::new(static_cast<void*>(&d_cells[i].cancelled)) std::atomic<bool>(false);
+            }
+        }
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+        ~mpmc_queue() noexcept {
+            while(try_consume([](reference){})){
+            }
+            cell_alloc_traits::deallocate(d_cell_alloc, d_cells, d_capacity);
+        }
+
+        template <typename ... Args>
+        bool try_emplace(Args&& ... args){
+            pointer p = try_claim();
+            if(p == nullptr){
+                return false;
+            }
+            alloc_traits::construct(d_alloc,p,std::forward<Args>(args)...);
+            publish(p);
+            return true;
+        }
+        bool try_push(param_value_type value){
+            return try_emplace(value);
+        }
+        bool try_push(rvalue_type rvalue){
+            return try_emplace(std::move(rvalue));
+        }
+        bool try_pop(reference value){
+            return try_consume([&value](reference element){ value = std::move(element); });
+        }
+        //calls f with the oldest element in its cell, then destroys it. returns false if the queue is empty
+        template<typename Function>
+        bool try_consume(Function f){
+            pointer p = try_borrow();
+            if(p == nullptr){
+                return false;
+            }
+            f(*p);
+            release(p);
+            return true;
+        }
+
+        //two-phase push: claims the next cell and returns its uninitialized storage, or nullptr if
+        //the queue is full. the caller constructs the element there and then publish()es it, or
+        //cancel()s the claim. consumers stop at a claimed cell until then, so every claim must be
+        //published or cancelled, also when constructing the element throws
+        pointer try_claim(){
+            size_type pos = d_enqueue_pos.load(std::memory_order_relaxed);
+            cell_type* cell;
+            for(;;){
+                cell = &d_cells[pos % d_capacity];
+                size_type sequence = cell->sequence.load(std::memory_order_acquire);
+                std::intptr_t diff = (std::intptr_t)sequence - (std::intptr_t)pos;
+                if(diff == 0){
+                    if(d_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                        break;
+                    }
+                }else if(diff < 0){
+                    //full, unless the oldest cell is a cancelled claim no consumer skipped yet
+                    if(sequence != pos - d_capacity + 1 || !cell->cancelled.load(std::memory_order_relaxed)){
+                        return nullptr;
+                    }
+                    skip_cancelled(cell, pos - d_capacity);
+                }else{
+                    pos = d_enqueue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            return element(cell);
+        }
+        //p from try_claim(), holding a constructed element
+        void publish(pointer p){
+            cell_type* cell = cell_of(p);
+            cell->sequence.store(cell->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+        //p from try_claim(), with no element constructed in it. the cell is published empty and
+        //freed by the next consumer or producer that reaches it
+        void cancel(pointer p){
+            cell_of(p)->cancelled.store(true, std::memory_order_relaxed);
+            publish(p);
+        }
+        //two-phase pop: the oldest element, left in its cell, or nullptr if the queue is empty.
+        //release() destroys it and frees the cell; producers stop at the cell until then, so every
+        //borrowed element must be released, also when reading it throws
+        pointer try_borrow(){
+            size_type pos = d_dequeue_pos.load(std::memory_order_relaxed);
+            cell_type* cell;
+            for(;;){
+                cell = &d_cells[pos % d_capacity];
+                std::intptr_t diff = (std::intptr_t)cell->sequence.load(std::memory_order_acquire) - (std::intptr_t)(pos + 1);
+                if(diff == 0 && cell->cancelled.load(std::memory_order_relaxed)){
+                    skip_cancelled(cell, pos);
+                    pos = d_dequeue_pos.load(std::memory_order_relaxed);
+                }else if(diff == 0){
+                    if(d_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)){
+                        break;
+                    }
+                }else if(diff < 0){
+                    return nullptr;
+                }else{
+                    pos = d_dequeue_pos.load(std::memory_order_relaxed);
+                }
+            }
+            return element(cell);
+        }
+        //p from try_borrow()
+        void release(pointer p){
+            cell_type* cell = cell_of(p);
+            size_type pos = cell->sequence.load(std::memory_order_relaxed) - 1;
+            alloc_traits::destroy(d_alloc,p);
+            cell->sequence.store(pos + d_capacity, std::memory_order_release);
+        }
+
+        //approximate while other threads are pushing or popping
+        size_type size() const {
+            size_type tail = d_enqueue_pos.load(std::memory_order_acquire);
+            size_type head = d_dequeue_pos.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        bool full() const {
+            return size() >= d_capacity;
+        }
+        size_type capacity() const {
+            return d_capacity;
+        }
+    private:
+        static pointer element(cell_type* cell){
+            return reinterpret_cast<pointer>(&cell->storage);
+        }
+        static cell_type* cell_of(pointer p){
+            return reinterpret_cast<cell_type*>(reinterpret_cast<char*>(p) - offsetof(cell_type, storage));
+        }
+        //frees the cancelled cell at dequeue position pos, unless another thread got to it first
+        void skip_cancelled(cell_type* cell, size_type pos){
+            if(d_dequeue_pos.compare_exchange_strong(pos, pos + 1, std::memory_order_relaxed)){
+                cell->cancelled.store(false, std::memory_order_relaxed);
+                cell->sequence.store(pos + d_capacity, std::memory_order_release);
+            }
+        }
+    private:
+        _cache_line_pad                                 d_pad0;
+        std::atomic<size_type>                          d_enqueue_pos;
+        _cache_line_pad                                 d_pad1;
+        std::atomic<size_type>                          d_dequeue_pos;
+        _cache_line_pad                                 d_pad2;
+        cell_type*                                      d_cells;
+        size_type                                       d_capacity;
+        allocator_type                                  d_alloc;
+        cell_allocator_type                             d_cell_alloc;
+    };
+}
+#endif
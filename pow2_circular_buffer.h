@@ -0,0 +1,483 @@
+#ifndef POW2_CIRCULAR_BUFFER_H_
+#define POW2_CIRCULAR_BUFFER_H_
+
+#include<stdexcept>
+#include<iterator>
+#include<memory>
+#include<algorithm>
+#include<utility>
+#include<type_traits>
+#include<limits>
+
+namespace gl {
+    template<typename Iterator>
+    struct segmented_iterator_traits;
+
+    template<typename CBType>
+    class _pow2_circular_buffer_const_iterator
+    {
+    public:
+        typedef _pow2_circular_buffer_const_iterator<CBType> this_type;
+        typedef typename CBType::value_type             value_type;
+        typedef typename CBType::size_type              size_type;
+        typedef typename CBType::difference_type        difference_type;
+        typedef typename CBType::const_pointer          pointer;
+        typedef typename CBType::const_reference        reference;
+        typedef std::random_access_iterator_tag         iterator_category;
+    public:
+        _pow2_circular_buffer_const_iterator() :d_buffer(nullptr),d_mask(0),d_index(0) {
+
+        }
+        _pow2_circular_buffer_const_iterator(typename CBType::pointer buffer, size_type mask, size_type index)
+            : d_buffer(buffer),d_mask(mask),d_index(index) {
+
+        }
+        reference operator*() const {
+            return d_buffer[d_index & d_mask];
+        }
+        pointer operator->() const {
+            return &(**this);
+        }
+        this_type& operator++() {
+            ++d_index;
+            return *this;
+        }
+        this_type operator++(int) {
+            this_type temp = *this;
+            ++d_index;
+            return temp;
+        }
+        this_type& operator+=(difference_type n){
+            d_index += n;
+            return *this;
+        }
+        this_type operator+(difference_type n) const{
+            this_type temp = *this;
+            temp += n;
+            return temp;
+        }
+        this_type& operator--() {
+            --d_index;
+            return *this;
+        }
+        this_type operator--(int) {
+            this_type temp = *this;
+            --d_index;
+            return temp;
+        }
+        this_type& operator-=(difference_type n) {
+            d_index -= n;
+            return *this;
+        }
+        this_type operator-(difference_type n) const {
+            this_type temp = *this;
+            temp -= n;
+            return temp;
+        }
+        difference_type operator-(const this_type& right) const {
+            return (difference_type)(d_index - right.d_index);
+        }
+        reference operator[](difference_type n) const {
+            return d_buffer[(d_index + n) & d_mask];
+        }
+        bool operator==(const this_type& right) const {
+            return d_index == right.d_index;
+        }
+        bool operator!=(const this_type& right) const {
+            return !(*this == right);
+        }
+        bool operator<(const this_type& right) const {
+            return (*this - right) < 0;
+        }
+        bool operator>(const this_type& right) const {
+            return right < *this;
+        }
+        bool operator<=(const this_type& right) const {
+            return !(right < *this);
+        }
+        bool operator>=(const this_type& right) const {
+            return !(*this < right);
+        }
+    private:
+        template<typename Iterator>
+        friend struct segmented_iterator_traits;
+    protected:
+        typename CBType::pointer d_buffer;
+        size_type d_mask;
+        size_type d_index;
+    };
+    template<typename CBType>
+    class _pow2_circular_buffer_iterator :public _pow2_circular_buffer_const_iterator<CBType>
+    {
+    public:
+        typedef _pow2_circular_buffer_iterator<CBType>       this_type;
+        typedef _pow2_circular_buffer_const_iterator<CBType> base_type;
+        typedef typename CBType::value_type         value_type;
+        typedef typename CBType::size_type          size_type;
+        typedef typename CBType::difference_type    difference_type;
+        typedef typename CBType::pointer            pointer;
+        typedef typename CBType::reference          reference;
+        typedef std::random_access_iterator_tag     iterator_category;
+    public:
+        _pow2_circular_buffer_iterator() {
+
+        }
+        _pow2_circular_buffer_iterator(pointer buffer, size_type mask, size_type index)
+            :base_type(buffer,mask,index) {
+
+        }
+        reference operator*() const{
+            return this->d_buffer[this->d_index & this->d_mask];
+        }
+        pointer operator->() const{
+            return &(**this);
+        }
+        this_type& operator++() {
+            ++this->d_index;
+            return *this;
+        }
+        this_type operator++(int) {
+            this_type temp = *this;
+            ++this->d_index;
+            return temp;
+        }
+        this_type& operator+=(difference_type n) {
+            this->d_index += n;
+            return *this;
+        }
+        this_type operator+(difference_type n) const {
+            this_type temp = *this;
+            temp += n;
+            return temp;
+        }
+        this_type& operator--() {
+            --this->d_index;
+            return *this;
+        }
+        this_type operator--(int) {
+            this_type temp = *this;
+            --this->d_index;
+            return temp;
+        }
+        this_type& operator-=(difference_type n) {
+            this->d_index -= n;
+            return *this;
+        }
+        this_type operator-(difference_type n) const {
+            this_type temp = *this;
+            temp -= n;
+            return temp;
+        }
+        difference_type operator-(const base_type& right) const {
+            return base_type::operator-(right);
+        }
+        reference operator[](difference_type n) const {
+            return this->d_buffer[(this->d_index + n) & this->d_mask];
+        }
+    };
+    //circular_buffer whose capacity is rounded up to a power of two.
+    //d_head/d_tail are free running counters, a slot is found by masking the counter,
+    //so indexing, size(), empty() and full() need no wrap branches.
+    template<typename T, typename Alloc=std::allocator<T>>
+    class pow2_circular_buffer {
+    public:
+        typedef Alloc										allocator_type;
+        typedef pow2_circular_buffer<T, Alloc>				this_type;
+        typedef std::allocator_traits<allocator_type>		alloc_traits;
+        typedef typename alloc_traits::value_type			value_type;
+        typedef typename alloc_traits::size_type			size_type;
+        typedef	typename alloc_traits::difference_type		difference_type;
+        typedef typename alloc_traits::pointer				pointer;
+        typedef typename alloc_traits::const_pointer		const_pointer;
+        typedef value_type&									reference;
+        typedef const value_type&							const_reference;
+        typedef T&&											rvalue_type;
+        typedef _pow2_circular_buffer_iterator<this_type>		iterator;
+        typedef _pow2_circular_buffer_const_iterator<this_type>	const_iterator;
+        typedef std::reverse_iterator<iterator>				reverse_iterator;
+        typedef std::reverse_iterator<const_iterator>		const_reverse_iterator;
+        typedef std::pair<pointer, size_type>				array_range;
+        typedef std::pair<const_pointer, size_type>			const_array_range;
+
+        typedef const value_type& param_value_type;
+    public:
+        explicit pow2_circular_buffer(const allocator_type & alloc = allocator_type()) noexcept
+            : d_alloc(alloc),d_buffer(nullptr),d_mask(size_type(-1)),d_head(0),d_tail(0){
+        }
+        explicit pow2_circular_buffer(size_type capacity, const allocator_type & alloc= allocator_type())
+            : d_alloc(alloc) {
+            init(capacity);
+        }
+        pow2_circular_buffer(size_type size, param_value_type value, const allocator_type & alloc = allocator_type())
+            : d_alloc(alloc) {
+            init(size);
+            for(; d_tail != size; ++d_tail){
+                alloc_traits::construct(d_alloc,slot(d_tail),value);
+            }
+        }
+        pow2_circular_buffer(size_type capacity, size_type size, param_value_type value,const allocator_type & alloc = allocator_type())
+            : d_alloc(alloc) {
+            init(capacity);
+            size = std::min(size, this->capacity());
+            for(; d_tail != size; ++d_tail){
+                alloc_traits::construct(d_alloc,slot(d_tail),value);
+            }
+        }
+        pow2_circular_buffer(const pow2_circular_buffer< T, Alloc > & other)
+            : d_alloc(other.d_alloc) {
+            init(other.capacity());
+            copy_from(other);
+        }
+        pow2_circular_buffer(pow2_circular_buffer< T, Alloc > && other) noexcept
+            : d_alloc(other.d_alloc),d_buffer(other.d_buffer),d_mask(other.d_mask),d_head(other.d_head),d_tail(other.d_tail){
+            other.d_buffer = nullptr;
+            other.d_mask = size_type(-1);
+            other.d_head = 0;
+            other.d_tail = 0;
+        }
+        template<typename InputIterator>
+        pow2_circular_buffer(InputIterator first, InputIterator last, const allocator_type & alloc = allocator_type(),
+                             typename std::enable_if<!std::is_integral<InputIterator>::value>::type* = nullptr)
+        : d_alloc(alloc) {
+            init(std::distance(first, last));
+            for(; first != last; ++first){
+                push_back(*first);
+            }
+        }
+        template<typename InputIterator>
+        pow2_circular_buffer(size_type capacity, InputIterator first, InputIterator last,const allocator_type & alloc = allocator_type(),
+                             typename std::enable_if<!std::is_integral<InputIterator>::value>::type* = nullptr)
+        : d_alloc(alloc) {
+            init(capacity);
+            for(; first != last; ++first){
+                push_back(*first);
+            }
+        }
+        pow2_circular_buffer< T, Alloc > & operator=(const pow2_circular_buffer< T, Alloc > & other) {
+            if(this != &other){
+                this_type temp(other);
+                swap(temp);
+            }
+            return *this;
+        }
+        pow2_circular_buffer< T, Alloc >& operator=(pow2_circular_buffer< T, Alloc > && other) noexcept {
+            this_type temp(std::move(other));
+            swap(temp);
+            return *this;
+        }
+        ~pow2_circular_buffer() noexcept {
+            if(d_buffer){
+                clear();
+                d_alloc.deallocate(d_buffer,capacity());
+            }
+        }
+
+        allocator_type get_allocator() const {
+            return d_alloc;
+        }
+        allocator_type& get_allocator() {
+            return d_alloc;
+        }
+
+        iterator begin() {
+            return iterator(d_buffer,d_mask,d_head);
+        }
+        iterator end() {
+            return iterator(d_buffer,d_mask,d_tail);
+        }
+        const_iterator begin() const {
+            return const_iterator(d_buffer,d_mask,d_head);
+        }
+        const_iterator end() const {
+            return const_iterator(d_buffer,d_mask,d_tail);
+        }
+        const_iterator cbegin() const {
+            return begin();
+        }
+        const_iterator cend() const {
+            return end();
+        }
+        reverse_iterator rbegin() {
+            return reverse_iterator(end());
+        }
+        reverse_iterator rend() {
+            return reverse_iterator(begin());
+        }
+        const_reverse_iterator rbegin() const {
+            return const_reverse_iterator(end());
+        }
+        const_reverse_iterator rend() const{
+            return const_reverse_iterator(begin());
+        }
+        reference operator[](size_type index) {
+            return *slot(d_head + index);
+        }
+        const_reference operator[](size_type index) const {
+            return *slot(d_head + index);
+        }
+        reference at(size_type index) {
+            if(index >= size()){
+                throw std::out_of_range("pow2_circular_buffer index is out of range");
+            }
+            return (*this)[index];
+        }
+        const_reference at(size_type index) const{
+            if(index >= size()){
+                throw std::out_of_range("pow2_circular_buffer index is out of range");
+            }
+            return (*this)[index];
+        }
+        reference front() {
+            return *slot(d_head);
+        }
+        reference back() {
+            return *slot(d_tail - 1);
+        }
+        const_reference front() const{
+            return *slot(d_head);
+        }
+        const_reference back() const{
+            return *slot(d_tail - 1);
+        }
+        size_type size() const {
+            return d_tail - d_head;
+        }
+        bool empty() const {
+            return d_tail == d_head;
+        }
+        bool full() const {
+            return size() == capacity();
+        }
+        size_type reserve() const {
+            return capacity() - size();
+        }
+        size_type capacity() const {
+            return d_mask + 1;
+        }
+
+        array_range array_one() {
+            return array_range(slot(d_head), first_run());
+        }
+        array_range array_two() {
+            return array_range(d_buffer, size() - first_run());
+        }
+        const_array_range array_one() const {
+            return const_array_range(slot(d_head), first_run());
+        }
+        const_array_range array_two() const {
+            return const_array_range(d_buffer, size() - first_run());
+        }
+
+        void swap(pow2_circular_buffer< T, Alloc > & other) noexcept{
+            std::swap(d_alloc,other.d_alloc);
+            std::swap(d_buffer,other.d_buffer);
+            std::swap(d_mask,other.d_mask);
+            std::swap(d_head,other.d_head);
+            std::swap(d_tail,other.d_tail);
+        }
+        void push_back(param_value_type value) {
+            emplace_back(value);
+        }
+        void push_back(rvalue_type rvalue) {
+            emplace_back(std::move(rvalue));
+        }
+        template <typename ... Args>
+        void emplace_back(Args&& ... args){
+            if(capacity()==0){
+                return;
+            }
+            if (full()) {
+                alloc_traits::destroy(d_alloc,slot(d_head));
+                ++d_head;
+            }
+            alloc_traits::construct(d_alloc,slot(d_tail),std::forward<Args>(args)...);
+            ++d_tail;
+        }
+        void push_front(param_value_type value){
+            emplace_front(value);
+        }
+        void push_front(rvalue_type rvalue){
+            emplace_front(std::move(rvalue));
+        }
+        template <typename ... Args>
+        void emplace_front(Args&& ... args){
+            if(capacity()==0){
+                return;
+            }
+            if (full()) {
+                --d_tail;
+                alloc_traits::destroy(d_alloc,slot(d_tail));
+            }
+            alloc_traits::construct(d_alloc,slot(d_head - 1),std::forward<Args>(args)...);
+            --d_head;
+        }
+
+        void pop_back(){
+            --d_tail;
+            alloc_traits::destroy(d_alloc,slot(d_tail));
+        }
+        void pop_front(){
+            alloc_traits::destroy(d_alloc,slot(d_head));
+            ++d_head;
+        }
+        void erase_begin(size_type n){
+            destroy_n(d_head, n);
+            d_head += n;
+        }
+        void erase_end(size_type n){
+            d_tail -= n;
+            destroy_n(d_tail, n);
+        }
+        void clear() {
+            destroy_n(d_head, size());
+            d_head = 0;
+            d_tail = 0;
+        }
+    private:
+        static size_type round_up(size_type n){
+            if(n == 0){
+                return 0;
+            }
+            if(n > (std::numeric_limits<size_type>::max() >> 1) + 1){
+                throw std::length_error("pow2_circular_buffer capacity is too large");
+            }
+            size_type ret = 1;
+            while(ret < n){
+                ret <<= 1;
+            }
+            return ret;
+        }
+        void init(size_type capacity){
+            capacity = round_up(capacity);
+            d_buffer = capacity ? d_alloc.allocate(capacity) : nullptr;
+            d_mask = capacity - 1;
+            d_head = 0;
+            d_tail = 0;
+        }
+        void copy_from(const this_type& other){
+            for(size_type i = other.d_head; i != other.d_tail; ++i,++d_tail){
+                alloc_traits::construct(d_alloc,slot(d_tail),*other.slot(i));
+            }
+        }
+        void destroy_n(size_type index, size_type n){
+            if(!std::is_trivially_destructible<value_type>::value){
+                for(; n > 0; --n,++index){
+                    alloc_traits::destroy(d_alloc,slot(index));
+                }
+            }
+        }
+        size_type first_run() const {
+            return std::min(size(), capacity() - (d_head & d_mask));
+        }
+        pointer slot(size_type index) const {
+            return d_buffer + (index & d_mask);
+        }
+    private:
+        allocator_type d_alloc;
+        pointer d_buffer;
+        size_type d_mask;
+        size_type d_head;
+        size_type d_tail;
+    };
+}
+#endif
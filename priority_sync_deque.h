@@ -0,0 +1,209 @@
+#ifndef PRIORITY_SYNC_DEQUE_H_
+#define PRIORITY_SYNC_DEQUE_H_
+
+#include "circular_buffer.h"
+#include "cache_line.h"
+#include "wait_strategy.h"
+#include "sync_deque.h"
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <stdexcept>
+
+namespace gl {
+    //bounded blocking queue with Lanes priority lanes, lane 0 the most urgent. each lane is a ring
+    //with its own capacity, so bulk traffic filling a low lane never blocks pushes to a higher one.
+    //a pop takes the oldest element of the most urgent non-empty lane; with a starvation quota q,
+    //after q pops in a row from that lane while less urgent lanes were waiting, the next pop serves
+    //one of the waiting lanes instead, taking them in turn so every lane makes progress.
+    //all lanes share one lock and one wait for consumers. lane indexes out of range throw std::out_of_range
+    template<typename T,std::size_t Lanes,bool is_full_block=true,typename Alloc=std::allocator<T>,typename WaitStrategy=park_wait>
+    class priority_sync_deque
+    {
+        static_assert(Lanes > 0, "priority_sync_deque needs at least one lane");
+    public:
+        typedef gl::circular_buffer<T, Alloc>               container_type;
+        typedef typename container_type::allocator_type     allocator_type;
+        typedef typename container_type::value_type         value_type;
+        typedef typename container_type::reference          reference;
+        typedef typename container_type::size_type          size_type;
+        typedef typename container_type::param_value_type   param_value_type;
+        typedef typename container_type::rvalue_type        rvalue_type;
+        typedef WaitStrategy                                wait_strategy;
+
+        static const size_type lanes = Lanes;
+    public:
+        //starvation_quota 0 serves lanes in strict priority order
+        priority_sync_deque(const std::array<size_type, Lanes>& capacities, size_type starvation_quota = 0,
+                            const allocator_type & alloc = allocator_type())
+            :d_streak(0),d_served(0),d_starved(0),d_quota(starvation_quota){
+            for(size_type i = 0; i < Lanes; ++i){
+                d_lanes[i] = container_type(capacities[i], alloc);
+            }
+        }
+        priority_sync_deque(size_type lane_capacity, size_type starvation_quota = 0,
+                            const allocator_type & alloc = allocator_type())
+            :d_streak(0),d_served(0),d_starved(0),d_quota(starvation_quota){
+            for(size_type i = 0; i < Lanes; ++i){
+                d_lanes[i] = container_type(lane_capacity, alloc);
+            }
+        }
+        template<typename ... Args>
+        void push_back(size_type lane, Args ... args){
+            check_lane(lane);
+            d_is_not_full[lane].wait([&]()->bool{ return try_emplace(lane, std::forward<Args>(args)...); });
+            d_is_not_empty.notify_one();
+        }
+        value_type pop_front(){
+            _sync_deque_slot<value_type> slot;
+            size_type lane = 0;
+            d_is_not_empty.wait([&]()->bool{ return try_consume(lane, [&slot](reference value){ slot.emplace(value); }); });
+            popped(lane);
+            return slot.take();
+        }
+
+        template<typename ... Args>
+        bool try_push(size_type lane, Args ... args){
+            check_lane(lane);
+            if(!try_emplace(lane, std::forward<Args>(args)...)){
+                return false;
+            }
+            d_is_not_empty.notify_one();
+            return true;
+        }
+        bool try_pop(reference value){
+            size_type lane = 0;
+            return try_pop(value, lane);
+        }
+        //also reports which lane the element came from
+        bool try_pop(reference value, size_type& lane){
+            if(!try_consume(lane, [&value](reference element){ value = std::move(element); })){
+                return false;
+            }
+            popped(lane);
+            return true;
+        }
+        template<typename Clock, typename Duration, typename ... Args>
+        bool push_until(size_type lane, const std::chrono::time_point<Clock, Duration>& deadline, Args ... args){
+            check_lane(lane);
+            if(!d_is_not_full[lane].wait_until([&]()->bool{ return try_emplace(lane, std::forward<Args>(args)...); }, deadline)){
+                return false;
+            }
+            d_is_not_empty.notify_one();
+            return true;
+        }
+        template<typename Rep, typename Period, typename ... Args>
+        bool push_for(size_type lane, const std::chrono::duration<Rep, Period>& timeout, Args ... args){
+            return push_until(lane, std::chrono::steady_clock::now() + timeout, std::forward<Args>(args)...);
+        }
+        template<typename Clock, typename Duration>
+        bool pop_until(reference value, const std::chrono::time_point<Clock, Duration>& deadline){
+            size_type lane = 0;
+            auto assign = [&value](reference element){ value = std::move(element); };
+            if(!d_is_not_empty.wait_until([&]()->bool{ return try_consume(lane, assign); }, deadline)){
+                return false;
+            }
+            popped(lane);
+            return true;
+        }
+        template<typename Rep, typename Period>
+        bool pop_for(reference value, const std::chrono::duration<Rep, Period>& timeout){
+            return pop_until(value, std::chrono::steady_clock::now() + timeout);
+        }
+
+        size_type size() const {
+            std::lock_guard<std::mutex> lock(d_mutex);
+            size_type n = 0;
+            for(auto& lane : d_lanes){
+                n += lane.size();
+            }
+            return n;
+        }
+        size_type size(size_type lane) const {
+            check_lane(lane);
+            std::lock_guard<std::mutex> lock(d_mutex);
+            return d_lanes[lane].size();
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        size_type capacity(size_type lane) const {
+            check_lane(lane);
+            std::lock_guard<std::mutex> lock(d_mutex);
+            return d_lanes[lane].capacity();
+        }
+    private:
+        template<typename ... Args>
+        bool try_emplace(size_type lane, Args&& ... args){
+            std::lock_guard<std::mutex> lock(d_mutex);
+            if(is_full_block && d_lanes[lane].full()){
+                return false;
+            }
+            d_lanes[lane].emplace_back(std::forward<Args>(args)...);
+            return true;
+        }
+        //picks the lane under the lock and reports it through lane
+        template<typename Function>
+        bool try_consume(size_type& lane, Function f){
+            std::lock_guard<std::mutex> lock(d_mutex);
+            size_type first = 0;
+            while(first < Lanes && d_lanes[first].empty()){
+                ++first;
+            }
+            if(first == Lanes){
+                return false;
+            }
+            size_type waiting = first + 1;
+            while(waiting < Lanes && d_lanes[waiting].empty()){
+                ++waiting;
+            }
+            lane = first;
+            if(waiting == Lanes){
+                d_streak = 0;
+            }else if(d_quota != 0 && d_served == first && d_streak >= d_quota){
+                //the next waiting lane after the one served last time, wrapping past the end
+                lane = d_starved;
+                do{
+                    lane = lane + 1 < Lanes ? lane + 1 : first + 1;
+                }while(lane <= first || d_lanes[lane].empty());
+                d_starved = lane;
+                d_streak = 0;
+            }else{
+                //a streak counts pops in a row from the same lane
+                d_streak = d_served == first ? d_streak + 1 : 1;
+            }
+            d_served = lane;
+            f(d_lanes[lane].front());
+            d_lanes[lane].pop_front();
+            return true;
+        }
+        static void check_lane(size_type lane){
+            if(lane >= Lanes){
+                throw std::out_of_range("priority_sync_deque lane out of range");
+            }
+        }
+        void popped(size_type lane){
+            if(is_full_block){
+                d_is_not_full[lane].notify_one();
+            }
+        }
+    private:
+        std::array<container_type, Lanes>                           d_lanes;
+        size_type                                                   d_streak;
+        size_type                                                   d_served;
+        size_type                                                   d_starved;
+        size_type                                                   d_quota;
+        _cache_line_pad                                             d_pad0;
+        mutable std::mutex                                          d_mutex;
+        _cache_line_pad                                             d_pad1;
+        wait_strategy                                               d_is_not_empty;
+        _cache_line_pad                                             d_pad2;
+        std::array<wait_strategy, Lanes>                            d_is_not_full;
+        _cache_line_pad                                             d_pad3;
+    };
+
+    template<typename T,std::size_t Lanes,bool is_full_block,typename Alloc,typename WaitStrategy>
+    const typename priority_sync_deque<T,Lanes,is_full_block,Alloc,WaitStrategy>::size_type
+    priority_sync_deque<T,Lanes,is_full_block,Alloc,WaitStrategy>::lanes;
+}
+#endif
@@ -0,0 +1,240 @@
+#ifndef QUEUE_STATS_H_
+#define QUEUE_STATS_H_
+
+#include "cache_line.h"
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace gl {
+    //wait times of one kind of blocked operation. bucket i counts waits of [2^i, 2^(i+1)) ns,
+    //bucket 0 also counts waits under 1ns and the last bucket everything longer
+    struct wait_stats {
+        static const std::size_t buckets = 40;
+
+        std::uint64_t                           count;
+        std::uint64_t                           total_ns;
+        std::uint64_t                           max_ns;
+        std::array<std::uint64_t, buckets>      histogram;
+
+        wait_stats() : count(0),total_ns(0),max_ns(0) {
+            histogram.fill(0);
+        }
+    };
+
+    //point-in-time copy of a queue's counters. fields are read one by one with relaxed loads,
+    //so they can be slightly inconsistent with each other while the queue is in use
+    struct queue_stats {
+        std::uint64_t   pushed;             //elements pushed
+        std::uint64_t   popped;             //elements popped
+        std::uint64_t   depth;              //size() when the snapshot was taken
+        std::uint64_t   max_depth;          //highest pushed - popped seen after a push
+        std::uint64_t   contended_locks;    //lock acquisitions that found the lock taken
+        std::uint64_t   grows;              //capacity increases of an elastic queue
+        std::uint64_t   shrinks;            //capacity decreases of an elastic queue
+        wait_stats      push_waits;         //pushes that found the queue full
+        wait_stats      pop_waits;          //pops that found the queue empty, or too few elements for a timed bulk pop
+
+        queue_stats() : pushed(0),popped(0),depth(0),max_depth(0),contended_locks(0),grows(0),shrinks(0) {
+        }
+    };
+
+    class _latency_histogram {
+    public:
+        _latency_histogram(){
+            reset();
+        }
+        void record(std::chrono::steady_clock::duration elapsed){
+            std::uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            std::size_t bucket = 0;
+            while(bucket + 1 < wait_stats::buckets && (ns >> (bucket + 1)) != 0){
+                ++bucket;
+            }
+            d_histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+            d_count.fetch_add(1, std::memory_order_relaxed);
+            d_total_ns.fetch_add(ns, std::memory_order_relaxed);
+            std::uint64_t max = d_max_ns.load(std::memory_order_relaxed);
+            while(ns > max && !d_max_ns.compare_exchange_weak(max, ns, std::memory_order_relaxed)){
+            }
+        }
+        wait_stats snapshot() const {
+            wait_stats stats;
+            stats.count = d_count.load(std::memory_order_relaxed);
+            stats.total_ns = d_total_ns.load(std::memory_order_relaxed);
+            stats.max_ns = d_max_ns.load(std::memory_order_relaxed);
+            for(std::size_t i = 0; i < wait_stats::buckets; ++i){
+                stats.histogram[i] = d_histogram[i].load(std::memory_order_relaxed);
+            }
+            return stats;
+        }
+        void reset(){
+            d_count.store(0, std::memory_order_relaxed);
+            d_total_ns.store(0, std::memory_order_relaxed);
+            d_max_ns.store(0, std::memory_order_relaxed);
+            for(auto& bucket : d_histogram){
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+    private:
+        std::atomic<std::uint64_t>                                  d_count;
+        std::atomic<std::uint64_t>                                  d_total_ns;
+        std::atomic<std::uint64_t>                                  d_max_ns;
+        std::array<std::atomic<std::uint64_t>, wait_stats::buckets> d_histogram;
+    };
+
+    //std::mutex that counts how often lock() found it already held
+    class contention_counting_mutex {
+    public:
+        contention_counting_mutex() : d_contended(0) {
+        }
+        void lock(){
+            if(!d_mutex.try_lock()){
+                d_contended.fetch_add(1, std::memory_order_relaxed);
+                d_mutex.lock();
+            }
+        }
+        bool try_lock(){
+            return d_mutex.try_lock();
+        }
+        void unlock(){
+            d_mutex.unlock();
+        }
+        std::uint64_t contended_count() const {
+            return d_contended.load(std::memory_order_relaxed);
+        }
+        void reset_contended_count(){
+            d_contended.store(0, std::memory_order_relaxed);
+        }
+    private:
+        std::mutex                  d_mutex;
+        std::atomic<std::uint64_t>  d_contended;
+    };
+    inline std::uint64_t _contended_count(const std::mutex&){
+        return 0;
+    }
+    inline std::uint64_t _contended_count(const contention_counting_mutex& mutex){
+        return mutex.contended_count();
+    }
+    inline void _reset_contended_count(std::mutex&){
+    }
+    inline void _reset_contended_count(contention_counting_mutex& mutex){
+        mutex.reset_contended_count();
+    }
+
+    //queue counters, compiled in only when Enabled. a queue derives from it and routes every
+    //push, pop and blocking wait through it; the disabled specialization is empty and forwards
+    //waits unchanged. waits are timed only when the operation could not complete straight away
+    template<bool Enabled>
+    class _queue_stats_recorder {
+    protected:
+        _queue_stats_recorder() : d_pushed(0),d_max_depth(0),d_popped(0) {
+        }
+        void record_pushed(std::size_t n){
+            std::uint64_t pushed = d_pushed.fetch_add(n, std::memory_order_relaxed) + n;
+            std::uint64_t popped = d_popped.load(std::memory_order_relaxed);
+            std::uint64_t depth = pushed > popped ? pushed - popped : 0;
+            std::uint64_t max = d_max_depth.load(std::memory_order_relaxed);
+            while(depth > max && !d_max_depth.compare_exchange_weak(max, depth, std::memory_order_relaxed)){
+            }
+        }
+        void record_popped(std::size_t n){
+            d_popped.fetch_add(n, std::memory_order_relaxed);
+        }
+        template<typename WaitStrategy, typename Predicate>
+        void wait_not_full(WaitStrategy& strategy, Predicate ready){
+            timed_wait(strategy, ready, d_push_waits);
+        }
+        template<typename WaitStrategy, typename Predicate, typename Clock, typename Duration>
+        bool wait_not_full_until(WaitStrategy& strategy, Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline){
+            return timed_wait_until(strategy, ready, deadline, d_push_waits);
+        }
+        template<typename WaitStrategy, typename Predicate>
+        void wait_not_empty(WaitStrategy& strategy, Predicate ready){
+            timed_wait(strategy, ready, d_pop_waits);
+        }
+        template<typename WaitStrategy, typename Predicate, typename Clock, typename Duration>
+        bool wait_not_empty_until(WaitStrategy& strategy, Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline){
+            return timed_wait_until(strategy, ready, deadline, d_pop_waits);
+        }
+        queue_stats snapshot() const {
+            queue_stats stats;
+            stats.pushed = d_pushed.load(std::memory_order_relaxed);
+            stats.popped = d_popped.load(std::memory_order_relaxed);
+            stats.max_depth = d_max_depth.load(std::memory_order_relaxed);
+            stats.push_waits = d_push_waits.snapshot();
+            stats.pop_waits = d_pop_waits.snapshot();
+            return stats;
+        }
+        void reset(){
+            d_pushed.store(0, std::memory_order_relaxed);
+            d_popped.store(0, std::memory_order_relaxed);
+            d_max_depth.store(0, std::memory_order_relaxed);
+            d_push_waits.reset();
+            d_pop_waits.reset();
+        }
+    private:
+        template<typename WaitStrategy, typename Predicate>
+        static void timed_wait(WaitStrategy& strategy, Predicate& ready, _latency_histogram& histogram){
+            if(ready()){
+                return;
+            }
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            strategy.wait(ready);
+            histogram.record(std::chrono::steady_clock::now() - begin);
+        }
+        template<typename WaitStrategy, typename Predicate, typename Clock, typename Duration>
+        static bool timed_wait_until(WaitStrategy& strategy, Predicate& ready, const std::chrono::time_point<Clock, Duration>& deadline,
+                                     _latency_histogram& histogram){
+            if(ready()){
+                return true;
+            }
+            std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+            bool result = strategy.wait_until(ready, deadline);
+            histogram.record(std::chrono::steady_clock::now() - begin);
+            return result;
+        }
+    private:
+        //producers and consumers update counters on separate cache lines
+        _cache_line_pad                                         d_pad0;
+        std::atomic<std::uint64_t>                              d_pushed;
+        std::atomic<std::uint64_t>                              d_max_depth;
+        _latency_histogram                                      d_push_waits;
+        _cache_line_pad                                         d_pad1;
+        std::atomic<std::uint64_t>                              d_popped;
+        _latency_histogram                                      d_pop_waits;
+    };
+
+    template<>
+    class _queue_stats_recorder<false> {
+    protected:
+        void record_pushed(std::size_t){
+        }
+        void record_popped(std::size_t){
+        }
+        template<typename WaitStrategy, typename Predicate>
+        void wait_not_full(WaitStrategy& strategy, Predicate ready){
+            strategy.wait(ready);
+        }
+        template<typename WaitStrategy, typename Predicate, typename Clock, typename Duration>
+        bool wait_not_full_until(WaitStrategy& strategy, Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline){
+            return strategy.wait_until(ready, deadline);
+        }
+        template<typename WaitStrategy, typename Predicate>
+        void wait_not_empty(WaitStrategy& strategy, Predicate ready){
+            strategy.wait(ready);
+        }
+        template<typename WaitStrategy, typename Predicate, typename Clock, typename Duration>
+        bool wait_not_empty_until(WaitStrategy& strategy, Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline){
+            return strategy.wait_until(ready, deadline);
+        }
+        queue_stats snapshot() const {
+            return queue_stats();
+        }
+        void reset(){
+        }
+    };
+}
+#endif
@@ -0,0 +1,154 @@
+#ifndef SHARDED_SYNC_DEQUE_H_
+#define SHARDED_SYNC_DEQUE_H_
+
+#include "sync_deque.h"
+#include <thread>
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace gl {
+    //blocking queue split into independent shards, each a locked ring with its lock and ring on
+    //their own cache lines. a producer pushes to the shard its thread hashes to and moves on to the
+    //next shard only when that one is full; a consumer sweeps the shards from a rotating start.
+    //elements from one producer stay in order while they land in the same shard, but there is
+    //no FIFO order across shards. without is_full_block a full home shard drops its own oldest element
+    template<typename T,bool is_full_block=true,typename Alloc=std::allocator<T>,typename WaitStrategy=park_wait>
+    class sharded_sync_deque
+    {
+    public:
+        typedef _sync_deque_backend<T, is_full_block, Alloc, locked_backend>   shard_type;
+        typedef typename shard_type::allocator_type         allocator_type;
+        typedef typename shard_type::value_type             value_type;
+        typedef typename shard_type::reference              reference;
+        typedef typename shard_type::size_type              size_type;
+        typedef typename shard_type::param_value_type       param_value_type;
+        typedef typename shard_type::rvalue_type            rvalue_type;
+        typedef WaitStrategy                                wait_strategy;
+    public:
+        //capacity is split evenly across the shards, rounding up
+        sharded_sync_deque(size_type capacity, size_type shards = std::thread::hardware_concurrency(),
+                           const allocator_type & alloc = allocator_type()){
+            shards = std::max<size_type>(shards, 1);
+            size_type shard_capacity = (capacity + shards - 1) / shards;
+            for(size_type i = 0; i < shards; ++i){
+                d_shards.emplace_back(new shard_type(shard_capacity, alloc));
+            }
+        }
+        template<typename ... Args>
+        void push_back(Args ... args){
+            size_type home = home_shard();
+            d_is_not_full.wait([&]()->bool{ return try_emplace(home, std::forward<Args>(args)...); });
+            d_is_not_empty.notify_one();
+        }
+        value_type pop_front(){
+            _sync_deque_slot<value_type> slot;
+            size_type start = next_sweep();
+            d_is_not_empty.wait([&]()->bool{ return try_consume(start, [&slot](reference value){ slot.emplace(value); }); });
+            popped();
+            return slot.take();
+        }
+        template<typename ... Args>
+        bool try_push(Args ... args){
+            if(!try_emplace(home_shard(), std::forward<Args>(args)...)){
+                return false;
+            }
+            d_is_not_empty.notify_one();
+            return true;
+        }
+        bool try_pop(reference value){
+            if(!try_consume(next_sweep(), [&value](reference element){ value = std::move(element); })){
+                return false;
+            }
+            popped();
+            return true;
+        }
+        template<typename Clock, typename Duration, typename ... Args>
+        bool push_until(const std::chrono::time_point<Clock, Duration>& deadline, Args ... args){
+            size_type home = home_shard();
+            if(!d_is_not_full.wait_until([&]()->bool{ return try_emplace(home, std::forward<Args>(args)...); }, deadline)){
+                return false;
+            }
+            d_is_not_empty.notify_one();
+            return true;
+        }
+        template<typename Rep, typename Period, typename ... Args>
+        bool push_for(const std::chrono::duration<Rep, Period>& timeout, Args ... args){
+            return push_until(std::chrono::steady_clock::now() + timeout, std::forward<Args>(args)...);
+        }
+        template<typename Clock, typename Duration>
+        bool pop_until(reference value, const std::chrono::time_point<Clock, Duration>& deadline){
+            size_type start = next_sweep();
+            auto assign = [&value](reference element){ value = std::move(element); };
+            if(!d_is_not_empty.wait_until([&]()->bool{ return try_consume(start, assign); }, deadline)){
+                return false;
+            }
+            popped();
+            return true;
+        }
+        template<typename Rep, typename Period>
+        bool pop_for(reference value, const std::chrono::duration<Rep, Period>& timeout){
+            return pop_until(value, std::chrono::steady_clock::now() + timeout);
+        }
+
+        //approximate while other threads are pushing or popping
+        size_type size() const {
+            size_type n = 0;
+            for(auto& shard : d_shards){
+                n += shard->size();
+            }
+            return n;
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        size_type capacity() const {
+            return d_shards.size() * d_shards.front()->capacity();
+        }
+        size_type shard_count() const {
+            return d_shards.size();
+        }
+    private:
+        size_type home_shard() const {
+            static thread_local size_type hash = std::hash<std::thread::id>()(std::this_thread::get_id());
+            return hash % d_shards.size();
+        }
+        size_type next_sweep() const {
+            static thread_local size_type sweep = std::hash<std::thread::id>()(std::this_thread::get_id());
+            return sweep++ % d_shards.size();
+        }
+        template<typename ... Args>
+        bool try_emplace(size_type home, Args&& ... args){
+            size_type n = d_shards.size();
+            for(size_type i = 0; i < n; ++i){
+                if(d_shards[(home + i) % n]->try_emplace_back(std::forward<Args>(args)...)){
+                    return true;
+                }
+            }
+            return false;
+        }
+        template<typename Function>
+        bool try_consume(size_type start, Function f){
+            size_type n = d_shards.size();
+            for(size_type i = 0; i < n; ++i){
+                if(d_shards[(start + i) % n]->try_consume_front(f)){
+                    return true;
+                }
+            }
+            return false;
+        }
+        void popped(){
+            if(is_full_block){
+                d_is_not_full.notify_one();
+            }
+        }
+    private:
+        std::vector<std::unique_ptr<shard_type>>    d_shards;
+        _cache_line_pad                             d_pad0;
+        wait_strategy                               d_is_not_empty;
+        _cache_line_pad                             d_pad1;
+        wait_strategy                               d_is_not_full;
+        _cache_line_pad                             d_pad2;
+    };
+}
+#endif
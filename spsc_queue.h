@@ -0,0 +1,191 @@
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+
+#include "cache_line.h"
+#include "wait_strategy.h"
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace gl {
+    //bounded wait-free queue for exactly one producer thread and one consumer thread.
+    //storage is a circular_buffer-style array of capacity+1 slots; the producer owns d_tail,
+    //the consumer owns d_head, and each keeps a cached copy of the other's index on its own
+    //cache line so the shared line is only read when the queue looks full or empty.
+    template<typename T, typename Alloc=std::allocator<T>>
+    class spsc_queue {
+    public:
+        typedef spsc_queue<T, Alloc>                    this_type;
+        typedef Alloc                                   allocator_type;
+        typedef std::allocator_traits<allocator_type>   alloc_traits;
+        typedef typename alloc_traits::value_type       value_type;
+        typedef typename alloc_traits::size_type        size_type;
+        typedef typename alloc_traits::pointer          pointer;
+        typedef value_type&                             reference;
+        typedef T&&                                     rvalue_type;
+
+        typedef const value_type& param_value_type;
+    public:
+        explicit spsc_queue(size_type capacity, const allocator_type & alloc = allocator_type())
+            : d_tail(0),d_head_cache(0),d_head(0),d_tail_cache(0),d_slots(capacity + 1),d_alloc(alloc) {
+            d_buffer = d_alloc.allocate(d_slots);
+        }
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+        ~spsc_queue() noexcept {
+            while(pop()){
+            }
+            d_alloc.deallocate(d_buffer, d_slots);
+        }
+
+        //producer side
+        template <typename ... Args>
+        bool try_emplace(Args&& ... args){
+            size_type tail = d_tail.load(std::memory_order_relaxed);
+            size_type next = tail + 1 == d_slots ? 0 : tail + 1;
+            if(next == d_head_cache){
+                d_head_cache = d_head.load(std::memory_order_acquire);
+                if(next == d_head_cache){
+                    return false;
+                }
+            }
+            alloc_traits::construct(d_alloc,d_buffer + tail,std::forward<Args>(args)...);
+            d_tail.store(next, std::memory_order_release);
+            return true;
+        }
+        bool try_push(param_value_type value){
+            return try_emplace(value);
+        }
+        bool try_push(rvalue_type rvalue){
+            return try_emplace(std::move(rvalue));
+        }
+
+        //consumer side
+        bool try_pop(reference value){
+            pointer p = front();
+            if(p == nullptr){
+                return false;
+            }
+            value = std::move(*p);
+            pop();
+            return true;
+        }
+        //the oldest element, or nullptr if the queue is empty
+        pointer front(){
+            size_type head = d_head.load(std::memory_order_relaxed);
+            if(head == d_tail_cache){
+                d_tail_cache = d_tail.load(std::memory_order_acquire);
+                if(head == d_tail_cache){
+                    return nullptr;
+                }
+            }
+            return d_buffer + head;
+        }
+        //destroys the oldest element, returns false if the queue is empty
+        bool pop(){
+            pointer p = front();
+            if(p == nullptr){
+                return false;
+            }
+            alloc_traits::destroy(d_alloc,p);
+            size_type head = d_head.load(std::memory_order_relaxed);
+            d_head.store(head + 1 == d_slots ? 0 : head + 1, std::memory_order_release);
+            return true;
+        }
+
+        //exact only when called from the producer or the consumer while the other side is idle
+        size_type size() const {
+            size_type tail = d_tail.load(std::memory_order_acquire);
+            size_type head = d_head.load(std::memory_order_acquire);
+            return tail >= head ? tail - head : tail + d_slots - head;
+        }
+        bool empty() const {
+            return d_head.load(std::memory_order_acquire) == d_tail.load(std::memory_order_acquire);
+        }
+        bool full() const {
+            return size() == capacity();
+        }
+        size_type capacity() const {
+            return d_slots - 1;
+        }
+    private:
+        _cache_line_pad                                 d_pad0;
+        std::atomic<size_type>                          d_tail;
+        size_type                                       d_head_cache;
+        _cache_line_pad                                 d_pad1;
+        std::atomic<size_type>                          d_head;
+        size_type                                       d_tail_cache;
+        _cache_line_pad                                 d_pad2;
+        pointer                                         d_buffer;
+        size_type                                       d_slots;
+        allocator_type                                  d_alloc;
+    };
+
+    //spsc_queue with sync_deque's blocking push_back/pop_front. with the default WaitStrategy
+    //a lock is only taken when a side actually has to sleep
+    template<typename T, typename Alloc=std::allocator<T>, typename WaitStrategy=spin_park_wait<>>
+    class blocking_spsc_queue {
+    public:
+        typedef spsc_queue<T, Alloc>                        queue_type;
+        typedef typename queue_type::allocator_type         allocator_type;
+        typedef typename queue_type::value_type             value_type;
+        typedef typename queue_type::size_type              size_type;
+        typedef typename queue_type::reference              reference;
+        typedef typename queue_type::rvalue_type            rvalue_type;
+        typedef typename queue_type::param_value_type       param_value_type;
+        typedef WaitStrategy                                wait_strategy;
+    public:
+        explicit blocking_spsc_queue(size_type capacity, const allocator_type & alloc = allocator_type())
+            : d_queue(capacity, alloc) {
+        }
+        template<typename ... Args>
+        void push_back(Args&& ... args){
+            while(!d_queue.try_emplace(std::forward<Args>(args)...)){
+                d_not_full.wait([this]()->bool{ return !d_queue.full(); });
+            }
+            d_not_empty.notify_one();
+        }
+        value_type pop_front(){
+            d_not_empty.wait([this]()->bool{ return !d_queue.empty(); });
+            value_type value(std::move(*d_queue.front()));
+            d_queue.pop();
+            d_not_full.notify_one();
+            return value;
+        }
+        template <typename ... Args>
+        bool try_emplace(Args&& ... args){
+            if(!d_queue.try_emplace(std::forward<Args>(args)...)){
+                return false;
+            }
+            d_not_empty.notify_one();
+            return true;
+        }
+        bool try_push(param_value_type value){
+            return try_emplace(value);
+        }
+        bool try_push(rvalue_type rvalue){
+            return try_emplace(std::move(rvalue));
+        }
+        bool try_pop(reference value){
+            if(!d_queue.try_pop(value)){
+                return false;
+            }
+            d_not_full.notify_one();
+            return true;
+        }
+        size_type size() const {
+            return d_queue.size();
+        }
+        bool empty() const {
+            return d_queue.empty();
+        }
+        size_type capacity() const {
+            return d_queue.capacity();
+        }
+    private:
+        queue_type      d_queue;
+        wait_strategy   d_not_empty;
+        wait_strategy   d_not_full;
+    };
+}
+#endif
@@ -0,0 +1,458 @@
+#ifndef STATIC_CIRCULAR_BUFFER_H_
+#define STATIC_CIRCULAR_BUFFER_H_
+
+#include<stdexcept>
+#include<iterator>
+#include<algorithm>
+#include<utility>
+#include<type_traits>
+#include<cstddef>
+#include<new>
+
+#if __cplusplus >= 201402L
+#define GL_CONSTEXPR14 constexpr
+#else
+#define GL_CONSTEXPR14
+#endif
+
+namespace gl {
+    template<typename Iterator>
+    struct segmented_iterator_traits;
+
+    template<typename CBType>
+    class _static_circular_buffer_const_iterator
+    {
+    public:
+        typedef _static_circular_buffer_const_iterator<CBType> this_type;
+        typedef typename CBType::value_type             value_type;
+        typedef typename CBType::size_type              size_type;
+        typedef typename CBType::difference_type        difference_type;
+        typedef typename CBType::const_pointer          pointer;
+        typedef typename CBType::const_reference        reference;
+        typedef std::random_access_iterator_tag         iterator_category;
+    public:
+        constexpr _static_circular_buffer_const_iterator() :d_cb(nullptr),d_index(0) {
+
+        }
+        constexpr _static_circular_buffer_const_iterator(const CBType* cb, size_type index) :d_cb(cb),d_index(index) {
+
+        }
+        constexpr reference operator*() const {
+            return (*d_cb)[d_index];
+        }
+        constexpr pointer operator->() const {
+            return &(**this);
+        }
+        GL_CONSTEXPR14 this_type& operator++() {
+            ++d_index;
+            return *this;
+        }
+        GL_CONSTEXPR14 this_type operator++(int) {
+            this_type temp = *this;
+            ++d_index;
+            return temp;
+        }
+        GL_CONSTEXPR14 this_type& operator+=(difference_type n){
+            d_index += n;
+            return *this;
+        }
+        constexpr this_type operator+(difference_type n) const{
+            return this_type(d_cb, d_index + n);
+        }
+        GL_CONSTEXPR14 this_type& operator--() {
+            --d_index;
+            return *this;
+        }
+        GL_CONSTEXPR14 this_type operator--(int) {
+            this_type temp = *this;
+            --d_index;
+            return temp;
+        }
+        GL_CONSTEXPR14 this_type& operator-=(difference_type n) {
+            d_index -= n;
+            return *this;
+        }
+        constexpr this_type operator-(difference_type n) const {
+            return this_type(d_cb, d_index - n);
+        }
+        constexpr difference_type operator-(const this_type& right) const {
+            return (difference_type)d_index - (difference_type)right.d_index;
+        }
+        constexpr reference operator[](difference_type n) const {
+            return (*d_cb)[d_index + n];
+        }
+        constexpr bool operator==(const this_type& right) const {
+            return d_index == right.d_index;
+        }
+        constexpr bool operator!=(const this_type& right) const {
+            return !(*this == right);
+        }
+        constexpr bool operator<(const this_type& right) const {
+            return d_index < right.d_index;
+        }
+        constexpr bool operator>(const this_type& right) const {
+            return right < *this;
+        }
+        constexpr bool operator<=(const this_type& right) const {
+            return !(right < *this);
+        }
+        constexpr bool operator>=(const this_type& right) const {
+            return !(*this < right);
+        }
+    private:
+        template<typename Iterator>
+        friend struct segmented_iterator_traits;
+    protected:
+        const CBType* d_cb;
+        size_type d_index;
+    };
+    template<typename CBType>
+    class _static_circular_buffer_iterator :public _static_circular_buffer_const_iterator<CBType>
+    {
+    public:
+        typedef _static_circular_buffer_iterator<CBType>       this_type;
+        typedef _static_circular_buffer_const_iterator<CBType> base_type;
+        typedef typename CBType::value_type         value_type;
+        typedef typename CBType::size_type          size_type;
+        typedef typename CBType::difference_type    difference_type;
+        typedef typename CBType::pointer            pointer;
+        typedef typename CBType::reference          reference;
+        typedef std::random_access_iterator_tag     iterator_category;
+    public:
+        constexpr _static_circular_buffer_iterator() {
+
+        }
+        constexpr _static_circular_buffer_iterator(CBType* cb, size_type index) :base_type(cb,index) {
+
+        }
+        constexpr reference operator*() const{
+            return (*const_cast<CBType*>(this->d_cb))[this->d_index];
+        }
+        constexpr pointer operator->() const{
+            return &(**this);
+        }
+        GL_CONSTEXPR14 this_type& operator++() {
+            ++this->d_index;
+            return *this;
+        }
+        GL_CONSTEXPR14 this_type operator++(int) {
+            this_type temp = *this;
+            ++this->d_index;
+            return temp;
+        }
+        GL_CONSTEXPR14 this_type& operator+=(difference_type n) {
+            this->d_index += n;
+            return *this;
+        }
+        constexpr this_type operator+(difference_type n) const {
+            return this_type(const_cast<CBType*>(this->d_cb), this->d_index + n);
+        }
+        GL_CONSTEXPR14 this_type& operator--() {
+            --this->d_index;
+            return *this;
+        }
+        GL_CONSTEXPR14 this_type operator--(int) {
+            this_type temp = *this;
+            --this->d_index;
+            return temp;
+        }
+        GL_CONSTEXPR14 this_type& operator-=(difference_type n) {
+            this->d_index -= n;
+            return *this;
+        }
+        constexpr this_type operator-(difference_type n) const {
+            return this_type(const_cast<CBType*>(this->d_cb), this->d_index - n);
+        }
+        constexpr difference_type operator-(const base_type& right) const {
+            return base_type::operator-(right);
+        }
+        constexpr reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+    };
+
+    //trivial element types live in a plain array so the whole buffer stays a literal,
+    //trivially copyable type usable in constant expressions
+    template<typename T, std::size_t N, bool is_trivial = std::is_trivial<T>::value>
+    class _static_circular_buffer_base {
+    protected:
+        constexpr _static_circular_buffer_base() :d_data(),d_first(0),d_size(0) {
+
+        }
+        GL_CONSTEXPR14 T* slot(std::size_t index) {
+            return d_data + index;
+        }
+        constexpr const T* slot(std::size_t index) const {
+            return d_data + index;
+        }
+        template<typename ... Args>
+        GL_CONSTEXPR14 void construct(std::size_t index, Args&& ... args) {
+            d_data[index] = T(std::forward<Args>(args)...);
+        }
+        GL_CONSTEXPR14 void destroy(std::size_t) {
+        }
+    protected:
+        T d_data[N];
+        std::size_t d_first;
+        std::size_t d_size;
+    };
+    template<typename T, std::size_t N>
+    class _static_circular_buffer_base<T, N, false> {
+    protected:
+        _static_circular_buffer_base() :d_first(0),d_size(0) {
+
+        }
+        _static_circular_buffer_base(const _static_circular_buffer_base& other) :d_first(0),d_size(0) {
+            for(; d_size != other.d_size; ++d_size){
+                construct(d_size, *other.slot((other.d_first + d_size) % N));
+            }
+        }
+        _static_circular_buffer_base(_static_circular_buffer_base&& other) :d_first(0),d_size(0) {
+            for(; d_size != other.d_size; ++d_size){
+                construct(d_size, std::move(*other.slot((other.d_first + d_size) % N)));
+            }
+        }
+        _static_circular_buffer_base& operator=(const _static_circular_buffer_base& other) {
+            if(this != &other){
+                destroy_all();
+                for(; d_size != other.d_size; ++d_size){
+                    construct(d_size, *other.slot((other.d_first + d_size) % N));
+                }
+            }
+            return *this;
+        }
+        _static_circular_buffer_base& operator=(_static_circular_buffer_base&& other) {
+            if(this != &other){
+                destroy_all();
+                for(; d_size != other.d_size; ++d_size){
+                    construct(d_size, std::move(*other.slot((other.d_first + d_size) % N)));
+                }
+            }
+            return *this;
+        }
+        ~_static_circular_buffer_base() {
+            destroy_all();
+        }
+        T* slot(std::size_t index) {
+            return reinterpret_cast<T*>(&d_data[index]);
+        }
+        const T* slot(std::size_t index) const {
+            return reinterpret_cast<const T*>(&d_data[index]);
+        }
+        template<typename ... Args>
+        void construct(std::size_t index, Args&& ... args) {
+            new (&d_data[index]) T(std::forward<Args>(args)...);
+        }
+        void destroy(std::size_t index) {
+            slot(index)->~T();
+        }
+        void destroy_all() {
+            for(std::size_t i = 0; i != d_size; ++i){
+                destroy((d_first + i) % N);
+            }
+            d_first = 0;
+            d_size = 0;
+        }
+    protected:
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type d_data[N];
+        std::size_t d_first;
+        std::size_t d_size;
+    };
+
+    //fixed capacity circular_buffer with inline storage and no heap allocation.
+    //the wrap arithmetic is done modulo the compile time constant N.
+    template<typename T, std::size_t N>
+    class static_circular_buffer :public _static_circular_buffer_base<T, N> {
+        static_assert(N > 0, "static_circular_buffer capacity must be greater than zero");
+        typedef _static_circular_buffer_base<T, N> base_type;
+    public:
+        typedef static_circular_buffer<T, N>                this_type;
+        typedef T                                           value_type;
+        typedef std::size_t                                 size_type;
+        typedef std::ptrdiff_t                              difference_type;
+        typedef T*                                          pointer;
+        typedef const T*                                    const_pointer;
+        typedef T&                                          reference;
+        typedef const T&                                    const_reference;
+        typedef T&&                                         rvalue_type;
+        typedef _static_circular_buffer_iterator<this_type>         iterator;
+        typedef _static_circular_buffer_const_iterator<this_type>   const_iterator;
+        typedef std::reverse_iterator<iterator>             reverse_iterator;
+        typedef std::reverse_iterator<const_iterator>       const_reverse_iterator;
+        typedef std::pair<pointer, size_type>               array_range;
+        typedef std::pair<const_pointer, size_type>         const_array_range;
+
+        typedef const value_type& param_value_type;
+    public:
+        constexpr static_circular_buffer() {
+
+        }
+        GL_CONSTEXPR14 static_circular_buffer(size_type size, param_value_type value) {
+            size = std::min(size, N);
+            for(; this->d_size != size; ++this->d_size){
+                this->construct(this->d_size, value);
+            }
+        }
+        template<typename InputIterator>
+        GL_CONSTEXPR14 static_circular_buffer(InputIterator first, InputIterator last,
+                                              typename std::enable_if<!std::is_integral<InputIterator>::value>::type* = nullptr) {
+            for(; first != last; ++first){
+                push_back(*first);
+            }
+        }
+
+        GL_CONSTEXPR14 iterator begin() {
+            return iterator(this,0);
+        }
+        GL_CONSTEXPR14 iterator end() {
+            return iterator(this,this->d_size);
+        }
+        constexpr const_iterator begin() const {
+            return const_iterator(this,0);
+        }
+        constexpr const_iterator end() const {
+            return const_iterator(this,this->d_size);
+        }
+        constexpr const_iterator cbegin() const {
+            return begin();
+        }
+        constexpr const_iterator cend() const {
+            return end();
+        }
+        reverse_iterator rbegin() {
+            return reverse_iterator(end());
+        }
+        reverse_iterator rend() {
+            return reverse_iterator(begin());
+        }
+        const_reverse_iterator rbegin() const {
+            return const_reverse_iterator(end());
+        }
+        const_reverse_iterator rend() const{
+            return const_reverse_iterator(begin());
+        }
+        GL_CONSTEXPR14 reference operator[](size_type index) {
+            return *this->slot(wrap(this->d_first + index));
+        }
+        constexpr const_reference operator[](size_type index) const {
+            return *this->slot(wrap(this->d_first + index));
+        }
+        GL_CONSTEXPR14 reference at(size_type index) {
+            if(index >= size()){
+                throw std::out_of_range("static_circular_buffer index is out of range");
+            }
+            return (*this)[index];
+        }
+        GL_CONSTEXPR14 const_reference at(size_type index) const{
+            if(index >= size()){
+                throw std::out_of_range("static_circular_buffer index is out of range");
+            }
+            return (*this)[index];
+        }
+        GL_CONSTEXPR14 reference front() {
+            return (*this)[0];
+        }
+        GL_CONSTEXPR14 reference back() {
+            return (*this)[this->d_size - 1];
+        }
+        constexpr const_reference front() const{
+            return (*this)[0];
+        }
+        constexpr const_reference back() const{
+            return (*this)[this->d_size - 1];
+        }
+        constexpr size_type size() const {
+            return this->d_size;
+        }
+        constexpr bool empty() const {
+            return this->d_size == 0;
+        }
+        constexpr bool full() const {
+            return this->d_size == N;
+        }
+        constexpr size_type reserve() const {
+            return N - this->d_size;
+        }
+        static constexpr size_type capacity() {
+            return N;
+        }
+
+        GL_CONSTEXPR14 array_range array_one() {
+            return array_range(this->slot(this->d_first), first_run());
+        }
+        GL_CONSTEXPR14 array_range array_two() {
+            return array_range(this->slot(0), this->d_size - first_run());
+        }
+        constexpr const_array_range array_one() const {
+            return const_array_range(this->slot(this->d_first), first_run());
+        }
+        constexpr const_array_range array_two() const {
+            return const_array_range(this->slot(0), this->d_size - first_run());
+        }
+
+        GL_CONSTEXPR14 void push_back(param_value_type value) {
+            emplace_back(value);
+        }
+        GL_CONSTEXPR14 void push_back(rvalue_type rvalue) {
+            emplace_back(std::move(rvalue));
+        }
+        template <typename ... Args>
+        GL_CONSTEXPR14 void emplace_back(Args&& ... args){
+            if (full()) {
+                pop_front();
+            }
+            this->construct(wrap(this->d_first + this->d_size),std::forward<Args>(args)...);
+            ++this->d_size;
+        }
+        GL_CONSTEXPR14 void push_front(param_value_type value){
+            emplace_front(value);
+        }
+        GL_CONSTEXPR14 void push_front(rvalue_type rvalue){
+            emplace_front(std::move(rvalue));
+        }
+        template <typename ... Args>
+        GL_CONSTEXPR14 void emplace_front(Args&& ... args){
+            if (full()) {
+                pop_back();
+            }
+            size_type first = wrap(this->d_first + N - 1);
+            this->construct(first,std::forward<Args>(args)...);
+            this->d_first = first;
+            ++this->d_size;
+        }
+        GL_CONSTEXPR14 void pop_back(){
+            --this->d_size;
+            this->destroy(wrap(this->d_first + this->d_size));
+        }
+        GL_CONSTEXPR14 void pop_front(){
+            this->destroy(this->d_first);
+            this->d_first = wrap(this->d_first + 1);
+            --this->d_size;
+        }
+        GL_CONSTEXPR14 void erase_begin(size_type n){
+            for(size_type i = 0; i != n; ++i){
+                this->destroy(wrap(this->d_first + i));
+            }
+            this->d_first = wrap(this->d_first + n);
+            this->d_size -= n;
+        }
+        GL_CONSTEXPR14 void erase_end(size_type n){
+            this->d_size -= n;
+            for(size_type i = 0; i != n; ++i){
+                this->destroy(wrap(this->d_first + this->d_size + i));
+            }
+        }
+        GL_CONSTEXPR14 void clear() {
+            erase_end(this->d_size);
+            this->d_first = 0;
+        }
+    private:
+        static constexpr size_type wrap(size_type index) {
+            return index % N;
+        }
+        constexpr size_type first_run() const {
+            return this->d_size < N - this->d_first ? this->d_size : N - this->d_first;
+        }
+    };
+}
+#endif
@@ -2,74 +2,750 @@
 #define SYNC_DEQUE_H_
 
 #include "circular_buffer.h"
-#include <condition_variable>
+#include "cache_line.h"
+#include "mpmc_queue.h"
+#include "wait_strategy.h"
+#include "coroutine_wait.h"
+#include "queue_stats.h"
 #include <mutex>
+#include <chrono>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
 
 namespace gl{
-    template<typename T,bool is_full_block=true>
-    class sync_deque
+    //sync_deque backends: a circular_buffer guarded by one mutex, supporting both ends,
+    //or a lock-free mpmc_queue for many producers and consumers, supporting push_back/pop_front only
+    //and holding at least 2 elements
+    struct locked_backend {};
+    struct mpmc_backend {};
+
+    //capacity bounds of an elastic locked_backend. a push that finds it full doubles the capacity,
+    //up to max, instead of waiting. once the ring has stayed at most a quarter full for idle it is
+    //halved, down to min, by a pop blocked on the empty queue or a timed pop that timed out,
+    //which check once per idle interval, or by sync_deque::shrink_to_fit_if_idle()
+    struct elastic_capacity {
+        std::size_t                             min;
+        std::size_t                             max;
+        std::chrono::steady_clock::duration     idle;
+
+        elastic_capacity(std::size_t min_, std::size_t max_, std::chrono::steady_clock::duration idle_ = std::chrono::seconds(1))
+            : min(min_),max(std::max(min_, max_)),idle(idle_) {
+        }
+    };
+
+    //non-blocking operations of a backend. try_ operations return false, or push nothing,
+    //instead of waiting; without is_full_block pushes never fail and drop the oldest element instead.
+    //with Stats the locked backend counts contended lock acquisitions. both count resizes, which only
+    //an elastic locked backend does
+    template<typename T,bool is_full_block,typename Alloc,typename Backend,bool Stats=false>
+    class _sync_deque_backend;
+
+    template<typename T,bool is_full_block,typename Alloc,bool Stats>
+    class _sync_deque_backend<T,is_full_block,Alloc,locked_backend,Stats>
     {
     public:
-        typedef gl::circular_buffer<T>       container_type;
-        typedef typename container_type::value_type     value_type;
-        typedef typename container_type::reference      reference;
-        typedef typename container_type::pointer        pointer;
-        typedef typename container_type::size_type      size_type;
-        typedef typename container_type::difference_type    difference_type;
+        typedef gl::circular_buffer<T, Alloc>               container_type;
+        typedef typename container_type::allocator_type     allocator_type;
+        typedef typename container_type::value_type         value_type;
+        typedef typename container_type::pointer            pointer;
+        typedef typename container_type::reference          reference;
+        typedef typename container_type::size_type          size_type;
         typedef typename container_type::param_value_type   param_value_type;
         typedef typename container_type::rvalue_type        rvalue_type;
+        typedef typename std::conditional<Stats, contention_counting_mutex, std::mutex>::type   mutex_type;
     public:
-        sync_deque(size_type capacity)
-            :d_container(capacity){
-            
+        _sync_deque_backend(size_type capacity, const allocator_type & alloc)
+            :d_container(capacity, alloc),d_elastic(capacity, capacity, std::chrono::steady_clock::duration::zero()),
+             d_busy(false),d_grows(0),d_shrinks(0){
+        }
+        _sync_deque_backend(const elastic_capacity & elastic, const allocator_type & alloc)
+            :d_container(elastic.min, alloc),d_elastic(elastic),d_busy(false),
+             d_idle_since(std::chrono::steady_clock::now()),d_grows(0),d_shrinks(0){
         }
         template<typename ... Args>
-        void push_back(Args ... args){
-            std::unique_lock<std::mutex> lock(d_mutex);
-            if(is_full_block){
-                d_is_not_full.wait(lock,[this]()->bool{ return !d_container.full();});
+        bool try_emplace_back(Args&& ... args){
+            std::lock_guard<mutex_type> lock(d_mutex);
+            if(d_container.full() && !grow(1) && is_full_block){
+                return false;
             }
             d_container.emplace_back(std::forward<Args>(args)...);
-            lock.unlock();
-            d_is_not_empty.notify_all();
+            note_load();
+            return true;
         }
         template<typename ... Args>
-        void push_front(Args ... args){
-            std::unique_lock<std::mutex> lock(d_mutex);
-            if(is_full_block){
-                d_is_not_full.wait(lock,[this]()->bool{ return !d_container.full(); });
+        bool try_emplace_front(Args&& ... args){
+            std::lock_guard<mutex_type> lock(d_mutex);
+            if(d_container.full() && !grow(1) && is_full_block){
+                return false;
             }
             d_container.emplace_front(std::forward<Args>(args)...);
-            lock.unlock();
-            d_is_not_empty.notify_all();
+            note_load();
+            return true;
         }
-        rvalue_type pop_front(){
-            std::unique_lock<std::mutex> lock(d_mutex);
-            d_is_not_empty.wait(lock,[this]()->bool{ return !d_container.empty(); });
-            reference value = d_container.front();
-            d_container.pop_front();
-            lock.unlock();
-            if(is_full_block){
-                d_is_not_full.notify_all();
+        template<typename Function>
+        bool try_consume_front(Function f){
+            std::lock_guard<mutex_type> lock(d_mutex);
+            if(d_container.empty()){
+                return false;
             }
-            return std::move(value);
+            f(d_container.front());
+            d_container.pop_front();
+            note_load();
+            return true;
         }
-        rvalue_type pop_back(){
-            std::unique_lock<std::mutex> lock(d_mutex);
-            d_is_not_empty.wait(lock,[this]()->bool{ return !d_container.empty(); });
-            reference value = d_container.back();
+        template<typename Function>
+        bool try_consume_back(Function f){
+            std::lock_guard<mutex_type> lock(d_mutex);
+            if(d_container.empty()){
+                return false;
+            }
+            f(d_container.back());
             d_container.pop_back();
-            lock.unlock();
+            note_load();
+            return true;
+        }
+        //pushes as much of the range as fits under one lock, returns the end of what was pushed
+        template<typename ForwardIterator>
+        ForwardIterator try_push_back_bulk(ForwardIterator first, ForwardIterator last){
+            std::lock_guard<mutex_type> lock(d_mutex);
+            size_type n = std::distance(first, last);
+            if(n > d_container.reserve()){
+                grow(n - d_container.reserve());
+            }
             if(is_full_block){
-                d_is_not_full.notify_all();
+                n = std::min(n, d_container.reserve());
+                last = first;
+                std::advance(last, n);
+            }
+            d_container.push_back(first, last);
+            note_load();
+            return last;
+        }
+        template<typename OutputIterator>
+        size_type try_pop_front_bulk(OutputIterator out, size_type max_n){
+            std::lock_guard<mutex_type> lock(d_mutex);
+            size_type n = d_container.pop_front(out, max_n);
+            note_load();
+            return n;
+        }
+        size_type size() const {
+            std::lock_guard<mutex_type> lock(d_mutex);
+            return d_container.size();
+        }
+        size_type capacity() const {
+            std::lock_guard<mutex_type> lock(d_mutex);
+            return d_container.capacity();
+        }
+        std::uint64_t contended_count() const {
+            return _contended_count(d_mutex);
+        }
+        void reset_contended_count(){
+            _reset_contended_count(d_mutex);
+        }
+        std::uint64_t grow_count() const {
+            std::lock_guard<mutex_type> lock(d_mutex);
+            return d_grows;
+        }
+        std::uint64_t shrink_count() const {
+            std::lock_guard<mutex_type> lock(d_mutex);
+            return d_shrinks;
+        }
+        bool elastic() const {
+            return d_elastic.min < d_elastic.max;
+        }
+        std::chrono::steady_clock::duration idle_interval() const {
+            return d_elastic.idle;
+        }
+        //halves the capacity if the ring stayed at most a quarter full since the previous call
+        //and for at least the idle interval. returns whether it shrank
+        bool shrink_if_idle(){
+            std::lock_guard<mutex_type> lock(d_mutex);
+            size_type capacity = d_container.capacity();
+            if(capacity <= d_elastic.min){
+                d_busy = false;
+                return false;
+            }
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if(d_busy || d_container.size() * 4 > capacity){
+                d_busy = false;
+                d_idle_since = now;
+                return false;
+            }
+            if(now - d_idle_since < d_elastic.idle){
+                return false;
+            }
+            d_container.set_capacity(std::max<size_type>(capacity / 2, d_elastic.min));
+            d_idle_since = now;
+            ++d_shrinks;
+            return true;
+        }
+    private:
+        //makes room for at least n more elements if the maximum allows any growth at all
+        bool grow(size_type n){
+            size_type capacity = d_container.capacity();
+            if(capacity >= d_elastic.max){
+                return false;
+            }
+            size_type target = std::max<size_type>(capacity * 2, 1);
+            while(target - d_container.size() < n && target < d_elastic.max){
+                target *= 2;
+            }
+            d_container.set_capacity(std::min<size_type>(target, d_elastic.max));
+            d_busy = true;
+            ++d_grows;
+            return true;
+        }
+        //remembers that the ring was more than a quarter full, a compare instead of a clock read
+        void note_load(){
+            if(d_container.size() * 4 > d_container.capacity()){
+                d_busy = true;
+            }
+        }
+    private:
+        //the lock is contended by threads that never touch the ring, keep it off the ring's line
+        _cache_line_pad                                 d_pad0;
+        container_type                                  d_container;
+        elastic_capacity                                d_elastic;
+        bool                                            d_busy;
+        std::chrono::steady_clock::time_point           d_idle_since;
+        std::uint64_t                                   d_grows;
+        std::uint64_t                                   d_shrinks;
+        _cache_line_pad                                 d_pad1;
+        mutable mutex_type                              d_mutex;
+    };
+
+    template<typename T,bool is_full_block,typename Alloc,bool Stats>
+    class _sync_deque_backend<T,is_full_block,Alloc,mpmc_backend,Stats>
+    {
+    public:
+        typedef gl::mpmc_queue<T, Alloc>                    container_type;
+        typedef typename container_type::allocator_type     allocator_type;
+        typedef typename container_type::value_type         value_type;
+        typedef typename container_type::pointer            pointer;
+        typedef typename container_type::reference          reference;
+        typedef typename container_type::size_type          size_type;
+        typedef typename container_type::param_value_type   param_value_type;
+        typedef typename container_type::rvalue_type        rvalue_type;
+    public:
+        _sync_deque_backend(size_type capacity, const allocator_type & alloc)
+            :d_container(capacity, alloc){
+        }
+        template<typename ... Args>
+        bool try_emplace_back(Args&& ... args){
+            while(!d_container.try_emplace(std::forward<Args>(args)...)){
+                if(is_full_block){
+                    return false;
+                }
+                d_container.try_consume([](reference){});
+            }
+            return true;
+        }
+        template<typename Function>
+        bool try_consume_front(Function f){
+            return d_container.try_consume(f);
+        }
+        template<typename ForwardIterator>
+        ForwardIterator try_push_back_bulk(ForwardIterator first, ForwardIterator last){
+            for(; first != last && try_emplace_back(*first); ++first){
+            }
+            return first;
+        }
+        pointer try_claim_back(){
+            pointer p;
+            while((p = d_container.try_claim()) == nullptr){
+                if(is_full_block){
+                    return nullptr;
+                }
+                d_container.try_consume([](reference){});
+            }
+            return p;
+        }
+        void publish_back(pointer p){
+            d_container.publish(p);
+        }
+        void cancel_back(pointer p){
+            d_container.cancel(p);
+        }
+        pointer try_borrow_front(){
+            return d_container.try_borrow();
+        }
+        void release_front(pointer p){
+            d_container.release(p);
+        }
+        template<typename OutputIterator>
+        size_type try_pop_front_bulk(OutputIterator out, size_type max_n){
+            size_type n = 0;
+            auto move_out = [&out](reference value){ *out = std::move(value); ++out; };
+            while(n < max_n && d_container.try_consume(move_out)){
+                ++n;
+            }
+            return n;
+        }
+        size_type size() const {
+            return d_container.size();
+        }
+        size_type capacity() const {
+            return d_container.capacity();
+        }
+        //there is no lock to contend and the capacity is fixed
+        std::uint64_t contended_count() const {
+            return 0;
+        }
+        void reset_contended_count(){
+        }
+        std::uint64_t grow_count() const {
+            return 0;
+        }
+        std::uint64_t shrink_count() const {
+            return 0;
+        }
+        bool elastic() const {
+            return false;
+        }
+        std::chrono::steady_clock::duration idle_interval() const {
+            return std::chrono::steady_clock::duration::zero();
+        }
+        bool shrink_if_idle(){
+            return false;
+        }
+    private:
+        container_type  d_container;
+    };
+
+    //holds a popped element between the backend handing it out and pop returning it
+    template<typename T>
+    class _sync_deque_slot
+    {
+    public:
+        void emplace(T& value){
+            ::new(static_cast<void*>(&d_storage)) T(std::move(value));
+        }
+        T take(){
+            T* p = reinterpret_cast<T*>(&d_storage);
+            T value(std::move(*p));
+            p->~T();
+            return value;
+        }
+    private:
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type d_storage;
+    };
+
+    //bounded blocking deque. Backend chooses the storage and locking (push_front/pop_back need locked_backend),
+    //WaitStrategy how blocked threads wait: busy_spin_wait, spin_yield_wait, spin_park_wait or park_wait.
+    //each push wakes at most one blocked pop and each pop at most one blocked push, bulk operations
+    //of n elements at most n.
+    //Stats compiles in counters and wait-time histograms read through stats(); without it they cost nothing
+    template<typename T,bool is_full_block=true,typename Alloc=std::allocator<T>,typename Backend=locked_backend,typename WaitStrategy=park_wait,bool Stats=false>
+    class sync_deque
+        : private _queue_stats_recorder<Stats>
+    {
+    public:
+        typedef _sync_deque_backend<T, is_full_block, Alloc, Backend, Stats>   backend_type;
+        typedef typename backend_type::container_type       container_type;
+        typedef typename backend_type::allocator_type       allocator_type;
+        typedef typename backend_type::value_type           value_type;
+        typedef typename backend_type::pointer              pointer;
+        typedef typename backend_type::reference            reference;
+        typedef typename backend_type::size_type            size_type;
+        typedef typename backend_type::param_value_type     param_value_type;
+        typedef typename backend_type::rvalue_type          rvalue_type;
+        typedef WaitStrategy                                wait_strategy;
+#if GL_HAS_COROUTINES
+    public:
+        //co_await on these suspends the coroutine instead of blocking the thread. the operation is
+        //completed by whichever thread makes it possible, then Executor is called with the coroutine
+        //to resume it. a suspended coroutine must not be destroyed before it is resumed
+        template<typename Executor>
+        class pop_awaiter : public _coroutine_waiter {
+        public:
+            pop_awaiter(sync_deque& queue, Executor executor)
+                :d_queue(queue),d_executor(executor){
+            }
+            //the other side is woken as soon as the element is taken, not when the executor
+            //gets round to resuming the coroutine
+            bool await_ready(){
+                if(!ready()){
+                    return false;
+                }
+                d_queue.popped(1);
+                return true;
+            }
+            bool await_suspend(std::coroutine_handle<> handle){
+                d_handle = handle;
+                if(d_queue.d_co_is_not_empty.suspend(this)){
+                    return true;
+                }
+                d_queue.popped(1);
+                return false;
+            }
+            value_type await_resume(){
+                return d_slot.take();
+            }
+            bool ready() override {
+                return d_queue.d_backend.try_consume_front([this](reference value){ d_slot.emplace(value); });
+            }
+            void resume() override {
+                //the coroutine may destroy this awaiter as soon as it runs
+                d_queue.popped(1);
+                std::coroutine_handle<> handle = d_handle;
+                Executor executor(d_executor);
+                executor(handle);
+            }
+        private:
+            sync_deque&                     d_queue;
+            Executor                        d_executor;
+            std::coroutine_handle<>         d_handle;
+            _sync_deque_slot<value_type>    d_slot;
+        };
+        template<typename Executor>
+        class push_awaiter : public _coroutine_waiter {
+        public:
+            push_awaiter(sync_deque& queue, value_type&& value, Executor executor)
+                :d_queue(queue),d_value(std::move(value)),d_executor(executor){
+            }
+            bool await_ready(){
+                if(!ready()){
+                    return false;
+                }
+                d_queue.pushed(1);
+                return true;
+            }
+            bool await_suspend(std::coroutine_handle<> handle){
+                d_handle = handle;
+                if(d_queue.d_co_is_not_full.suspend(this)){
+                    return true;
+                }
+                d_queue.pushed(1);
+                return false;
+            }
+            void await_resume(){
+            }
+            bool ready() override {
+                return d_queue.d_backend.try_emplace_back(std::move(d_value));
+            }
+            void resume() override {
+                d_queue.pushed(1);
+                std::coroutine_handle<> handle = d_handle;
+                Executor executor(d_executor);
+                executor(handle);
+            }
+        private:
+            sync_deque&                     d_queue;
+            value_type                      d_value;
+            Executor                        d_executor;
+            std::coroutine_handle<>         d_handle;
+        };
+#endif
+    public:
+        //an mpmc_backend raises a capacity under 2 to 2, capacity() reports the one in effect
+        sync_deque(size_type capacity, const allocator_type & alloc = allocator_type())
+            :d_backend(capacity, alloc),d_batch_waiters(0){
+
+        }
+        //elastic capacity, locked_backend only. starts at elastic.min
+        sync_deque(const elastic_capacity & elastic, const allocator_type & alloc = allocator_type())
+            :d_backend(elastic, alloc),d_batch_waiters(0){
+
+        }
+        template<typename ... Args>
+        void push_back(Args ... args){
+            this->wait_not_full(d_is_not_full, [&]()->bool{ return d_backend.try_emplace_back(std::forward<Args>(args)...); });
+            pushed(1);
+        }
+        template<typename ... Args>
+        void push_front(Args ... args){
+            this->wait_not_full(d_is_not_full, [&]()->bool{ return d_backend.try_emplace_front(std::forward<Args>(args)...); });
+            pushed(1);
+        }
+        value_type pop_front(){
+            _sync_deque_slot<value_type> slot;
+            wait_to_pop([&]()->bool{ return d_backend.try_consume_front([&slot](reference value){ slot.emplace(value); }); });
+            popped(1);
+            return slot.take();
+        }
+        value_type pop_back(){
+            _sync_deque_slot<value_type> slot;
+            wait_to_pop([&]()->bool{ return d_backend.try_consume_back([&slot](reference value){ slot.emplace(value); }); });
+            popped(1);
+            return slot.take();
+        }
+#if GL_HAS_COROUTINES
+        //value_type v = co_await q.async_pop_front(); resumes on the pushing thread by default
+        pop_awaiter<inline_executor> async_pop_front(){
+            return pop_awaiter<inline_executor>(*this, inline_executor());
+        }
+        template<typename Executor>
+        pop_awaiter<Executor> async_pop_front(Executor executor){
+            return pop_awaiter<Executor>(*this, executor);
+        }
+        push_awaiter<inline_executor> async_push_back(value_type value){
+            return push_awaiter<inline_executor>(*this, std::move(value), inline_executor());
+        }
+        template<typename Executor>
+        push_awaiter<Executor> async_push_back(value_type value, Executor executor){
+            return push_awaiter<Executor>(*this, std::move(value), executor);
+        }
+#endif
+
+        template<typename ... Args>
+        bool try_push(Args ... args){
+            if(!d_backend.try_emplace_back(std::forward<Args>(args)...)){
+                return false;
+            }
+            pushed(1);
+            return true;
+        }
+        bool try_pop(reference value){
+            if(!d_backend.try_consume_front([&value](reference element){ value = std::move(element); })){
+                return false;
+            }
+            popped(1);
+            return true;
+        }
+        //returns false without pushing if there is still no room by the deadline
+        template<typename Clock, typename Duration, typename ... Args>
+        bool push_until(const std::chrono::time_point<Clock, Duration>& deadline, Args ... args){
+            if(!this->wait_not_full_until(d_is_not_full, [&]()->bool{ return d_backend.try_emplace_back(std::forward<Args>(args)...); }, deadline)){
+                return false;
+            }
+            pushed(1);
+            return true;
+        }
+        template<typename Rep, typename Period, typename ... Args>
+        bool push_for(const std::chrono::duration<Rep, Period>& timeout, Args ... args){
+            return push_until(std::chrono::steady_clock::now() + timeout, std::forward<Args>(args)...);
+        }
+        //returns false leaving value untouched if the queue is still empty by the deadline
+        template<typename Clock, typename Duration>
+        bool pop_until(reference value, const std::chrono::time_point<Clock, Duration>& deadline){
+            auto assign = [&value](reference element){ value = std::move(element); };
+            if(!this->wait_not_empty_until(d_is_not_empty, [&]()->bool{ return d_backend.try_consume_front(assign); }, deadline)){
+                d_backend.shrink_if_idle();
+                return false;
+            }
+            popped(1);
+            return true;
+        }
+        template<typename Rep, typename Period>
+        bool pop_for(reference value, const std::chrono::duration<Rep, Period>& timeout){
+            return pop_until(value, std::chrono::steady_clock::now() + timeout);
+        }
+
+        //two-phase push and pop (mpmc_backend only): an element is built and read in its cell,
+        //with no lock held and without being moved in or out. claim_back() waits for a free cell and
+        //returns its uninitialized storage; construct the element there, then publish_back() it.
+        //borrow_front() waits for the oldest element and leaves it in place until release_front().
+        //the queue stalls at a claimed or borrowed cell, so each must be published or cancel_back()ed,
+        //or released, also when constructing or reading the element throws
+        pointer claim_back(){
+            static_assert(std::is_same<Backend, mpmc_backend>::value, "claim_back needs sync_deque with mpmc_backend");
+            pointer p = nullptr;
+            this->wait_not_full(d_is_not_full, [&]()->bool{ return (p = d_backend.try_claim_back()) != nullptr; });
+            return p;
+        }
+        pointer try_claim_back(){
+            static_assert(std::is_same<Backend, mpmc_backend>::value, "try_claim_back needs sync_deque with mpmc_backend");
+            return d_backend.try_claim_back();
+        }
+        void publish_back(pointer p){
+            static_assert(std::is_same<Backend, mpmc_backend>::value, "publish_back needs sync_deque with mpmc_backend");
+            d_backend.publish_back(p);
+            pushed(1);
+        }
+        //gives a claimed cell back with no element in it. consumers stopped at the cell skip it and
+        //the free cell may unblock a producer, so both sides are woken
+        void cancel_back(pointer p){
+            static_assert(std::is_same<Backend, mpmc_backend>::value, "cancel_back needs sync_deque with mpmc_backend");
+            d_backend.cancel_back(p);
+            d_is_not_empty.notify_all();
+            d_is_not_full.notify_all();
+#if GL_HAS_COROUTINES
+            d_co_is_not_empty.notify_all();
+            d_co_is_not_full.notify_all();
+#endif
+        }
+        pointer borrow_front(){
+            static_assert(std::is_same<Backend, mpmc_backend>::value, "borrow_front needs sync_deque with mpmc_backend");
+            pointer p = nullptr;
+            this->wait_not_empty(d_is_not_empty, [&]()->bool{ return (p = d_backend.try_borrow_front()) != nullptr; });
+            return p;
+        }
+        pointer try_borrow_front(){
+            static_assert(std::is_same<Backend, mpmc_backend>::value, "try_borrow_front needs sync_deque with mpmc_backend");
+            return d_backend.try_borrow_front();
+        }
+        void release_front(pointer p){
+            static_assert(std::is_same<Backend, mpmc_backend>::value, "release_front needs sync_deque with mpmc_backend");
+            d_backend.release_front(p);
+            popped(1);
+        }
+
+        //pushes the range in as few chunks as the free space allows, waking consumers once per chunk
+        template<typename ForwardIterator>
+        void push_back_bulk(ForwardIterator first, ForwardIterator last){
+            while(first != last){
+                ForwardIterator next = first;
+                this->wait_not_full(d_is_not_full, [&]()->bool{ return (next = d_backend.try_push_back_bulk(first, last)) != first; });
+                pushed(std::distance(first, next));
+                first = next;
+            }
+        }
+        //moves up to max_n elements to out, waiting until there is at least one
+        template<typename OutputIterator>
+        size_type pop_front_bulk(OutputIterator out, size_type max_n){
+            if(max_n == 0){
+                return 0;
             }
-            return std::move(value);
+            size_type n = 0;
+            wait_to_pop([&]()->bool{ return (n = d_backend.try_pop_front_bulk(out, max_n)) != 0; });
+            popped(n);
+            return n;
+        }
+        //waits until there are at least min_n elements or timeout expires, then moves up to max_n.
+        //returns 0 if the queue stayed empty
+        template<typename OutputIterator, typename Rep, typename Period>
+        size_type pop_front_bulk(OutputIterator out, size_type max_n, size_type min_n, const std::chrono::duration<Rep, Period>& timeout){
+            min_n = std::min(std::min(min_n, max_n), d_backend.capacity());
+            d_batch_waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            this->wait_not_empty_until(d_is_batch_ready, [this,min_n]()->bool{ return d_backend.size() >= min_n; },
+                                       std::chrono::steady_clock::now() + timeout);
+            d_batch_waiters.fetch_sub(1, std::memory_order_relaxed);
+            size_type n = d_backend.try_pop_front_bulk(out, max_n);
+            if(n > 0){
+                popped(n);
+            }else{
+                d_backend.shrink_if_idle();
+            }
+            return n;
+        }
+
+        //for a WaitStrategy with a descriptor (eventfd_wait): the descriptor that polls readable once
+        //elements were pushed, to register in the consumer's own epoll loop. it is readable when first
+        //returned, which covers elements pushed before. the strategies for blocked pushes and bulk
+        //pops only create their descriptors if a thread waits on them
+        int native_handle() const {
+            return d_is_not_empty.native_handle();
+        }
+        //moves up to max_n elements to out without waiting. call it each time the descriptor is
+        //readable, again while it returns max_n. the descriptor's readiness is cleared only once
+        //the queue ran empty, so producers do not signal it while the consumer is still taking
+        template<typename OutputIterator>
+        size_type drain_front(OutputIterator out, size_type max_n){
+            size_type n = d_backend.try_pop_front_bulk(out, max_n);
+            if(n < max_n){
+                //anything pushed before the drain is taken now, anything after signals again
+                d_is_not_empty.drain();
+                for(size_type i = 0; i < n; ++i){
+                    ++out;
+                }
+                n += d_backend.try_pop_front_bulk(out, max_n - n);
+            }
+            if(n > 0){
+                popped(n);
+            }
+            return n;
+        }
+
+        size_type size() const {
+            return d_backend.size();
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        size_type capacity() const {
+            return d_backend.capacity();
+        }
+        //elastic locked_backend: halves the capacity, down to min, if the ring stayed at most a
+        //quarter full since the previous check and for at least the idle interval. blocked pops
+        //check by themselves, call it from a timer if consumers never block. returns whether it shrank
+        bool shrink_to_fit_if_idle(){
+            return d_backend.shrink_if_idle();
+        }
+        //without Stats only depth and the resize counts are filled in
+        queue_stats stats() const {
+            queue_stats stats = this->snapshot();
+            stats.depth = size();
+            stats.contended_locks = d_backend.contended_count();
+            stats.grows = d_backend.grow_count();
+            stats.shrinks = d_backend.shrink_count();
+            return stats;
+        }
+        void reset_stats(){
+            this->reset();
+            d_backend.reset_contended_count();
         }
     private:
-        container_type          d_container;
-        std::mutex              d_mutex;
-        std::condition_variable d_is_not_empty;
-        std::condition_variable d_is_not_full;
+        //a consumer blocked on an elastic queue wakes once per idle interval to check whether the
+        //ring can shrink, so an idle queue gives its memory back without further traffic
+        template<typename Predicate>
+        void wait_to_pop(Predicate ready){
+            if(!d_backend.elastic()){
+                this->wait_not_empty(d_is_not_empty, ready);
+                return;
+            }
+            std::chrono::steady_clock::duration interval = std::max<std::chrono::steady_clock::duration>(
+                d_backend.idle_interval(), std::chrono::milliseconds(1));
+            while(!this->wait_not_empty_until(d_is_not_empty, ready, std::chrono::steady_clock::now() + interval)){
+                d_backend.shrink_if_idle();
+            }
+        }
+        void pushed(size_type n){
+            this->record_pushed(n);
+            if(n == 1){
+                d_is_not_empty.notify_one();
+            }else{
+                d_is_not_empty.notify_n(n);
+            }
+            //strategies that sleep fence in notify, which orders the push above before this load
+            //as the fence after registering orders a batch waiter's registration before its check.
+            //strategies that don't only poll and need no notify
+            if(d_batch_waiters.load(std::memory_order_relaxed) != 0){
+                d_is_batch_ready.notify_all();
+            }
+#if GL_HAS_COROUTINES
+            if(n == 1){
+                d_co_is_not_empty.notify_one();
+            }else{
+                d_co_is_not_empty.notify_n(n);
+            }
+#endif
+        }
+        void popped(size_type n){
+            this->record_popped(n);
+            if(!is_full_block){
+                return;
+            }
+            if(n == 1){
+                d_is_not_full.notify_one();
+            }else{
+                d_is_not_full.notify_n(n);
+            }
+#if GL_HAS_COROUTINES
+            if(n == 1){
+                d_co_is_not_full.notify_one();
+            }else{
+                d_co_is_not_full.notify_n(n);
+            }
+#endif
+        }
+    private:
+        backend_type                                d_backend;
+        _cache_line_pad                             d_pad0;
+        wait_strategy                               d_is_not_empty;
+        _cache_line_pad                             d_pad1;
+        wait_strategy                               d_is_not_full;
+        _cache_line_pad                             d_pad2;
+        wait_strategy                               d_is_batch_ready;
+        std::atomic<int>                            d_batch_waiters;
+#if GL_HAS_COROUTINES
+        _cache_line_pad                             d_pad3;
+        coroutine_wait_list                         d_co_is_not_empty;
+        _cache_line_pad                             d_pad4;
+        coroutine_wait_list                         d_co_is_not_full;
+#endif
+        _cache_line_pad                             d_pad5;
     };
 }
 
@@ -0,0 +1,114 @@
+//broadcast_ring: every consumer reads every element, dependent consumers trail the ones
+//they depend on, and the producer never laps the slowest consumer.
+//from the repository root: g++ -std=c++14 -pthread -I. test/broadcast_ring_test.cpp && ./a.out
+#undef NDEBUG
+#include "broadcast_ring.h"
+#include <cassert>
+#include <cstdio>
+#include <cstddef>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    typedef gl::broadcast_ring<long> ring_type;
+
+    static_assert(alignof(ring_type) <= alignof(std::max_align_t), "broadcast_ring is over-aligned");
+    static_assert(alignof(ring_type::consumer) <= alignof(std::max_align_t), "broadcast_ring::consumer is over-aligned");
+
+    void test_single_thread(){
+        ring_type ring(3);
+        assert(ring.capacity() == 4 && ring.consumer_count() == 0);
+        ring_type::consumer& first = ring.add_consumer();
+        ring_type::consumer& second = ring.add_consumer();
+        ring_type::consumer& last = ring.add_consumer({&first, &second});
+        assert(ring.consumer_count() == 3);
+
+        for(long i = 0; i < 4; ++i){
+            assert(ring.try_push(i));
+        }
+        //the slowest consumer has not read anything yet
+        assert(!ring.try_push(4) && ring.try_claim() == nullptr);
+        assert(ring.sequence() == 4 && first.available() == 4);
+        assert(last.available() == 0);
+
+        std::vector<long> seen;
+        auto record = [&seen](const long& v){ seen.push_back(v); };
+        assert(first.try_consume(record, 3) == 3);
+        assert(second.try_consume(record, 1) == 1);
+        assert(last.available() == 1 && last.try_consume(record) == 1);
+        assert(last.try_consume(record) == 0);
+        assert((seen == std::vector<long>{0, 1, 2, 0, 0}));
+        assert(first.sequence() == 3 && second.sequence() == 1 && last.sequence() == 1);
+
+        //one slot freed by all three
+        assert(ring.try_push(4) && !ring.try_push(5));
+        assert(second.try_consume(record) == 4);
+        assert(last.try_consume(record) == 2);
+        assert(first.try_consume(record) == 2);
+        assert(last.try_consume(record) == 2);
+        assert(first.available() == 0 && second.available() == 0 && last.available() == 0);
+    }
+    //slots are constructed once and reused in place
+    void test_claim_in_place(){
+        gl::broadcast_ring<std::string> ring(2);
+        gl::broadcast_ring<std::string>::consumer& reader = ring.add_consumer();
+        for(int i = 0; i < 10; ++i){
+            std::string& slot = ring.claim();
+            slot.assign(20, char('a' + i));
+            ring.publish();
+            std::string value;
+            assert(reader.consume([&value](const std::string& v){ value = v; }) == 1);
+            assert(value == std::string(20, char('a' + i)));
+        }
+        //a consumer added later starts at the producer's sequence
+        gl::broadcast_ring<std::string>::consumer& late = ring.add_consumer();
+        assert(late.sequence() == 10 && late.available() == 0);
+    }
+    //every consumer sees every element in order, the last one only after the first two
+    void test_threads(){
+        const long items = 20000;
+        ring_type ring(64);
+        ring_type::consumer& first = ring.add_consumer();
+        ring_type::consumer& second = ring.add_consumer();
+        ring_type::consumer& last = ring.add_consumer({&first, &second});
+        ring_type::consumer* all[] = {&first, &second, &last};
+        std::vector<std::thread> threads;
+        std::atomic<long> sums[3];
+        for(int i = 0; i < 3; ++i){
+            sums[i] = 0;
+            threads.emplace_back([&, i]{
+                long taken = 0;
+                long expected = 1;
+                while(taken < items){
+                    taken += all[i]->consume([&](const long& v){
+                        assert(v == expected);
+                        if(i == 2){
+                            assert(first.sequence() >= std::size_t(v) && second.sequence() >= std::size_t(v));
+                        }
+                        ++expected;
+                        sums[i] += v;
+                    }, 16);
+                }
+            });
+        }
+        for(long i = 1; i <= items; ++i){
+            ring.push(i);
+        }
+        for(auto& t : threads){
+            t.join();
+        }
+        for(int i = 0; i < 3; ++i){
+            assert(sums[i].load() == items * (items + 1) / 2);
+        }
+    }
+}
+
+int main(){
+    test_single_thread();
+    test_claim_in_place();
+    test_threads();
+    std::puts("broadcast_ring_test passed");
+    return 0;
+}
@@ -0,0 +1,106 @@
+//segment-wise algorithm overloads for circular_buffer, pow2_circular_buffer and
+//static_circular_buffer, checked against the std:: algorithms for every rotation and subrange.
+//from the repository root: g++ -std=c++11 -I. test/circular_buffer_algorithm_test.cpp && ./a.out
+#undef NDEBUG
+#include "circular_buffer_algorithm.h"
+#include <cassert>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <vector>
+
+namespace {
+    const int capacity = 8;
+
+    //a buffer holding size elements, its first one at slot offset
+    template<typename Buffer>
+    void fill_rotated(Buffer& cb, int offset, int size){
+        cb.clear();
+        for(int i = 0; i < offset; ++i){
+            cb.push_back(-1);
+            cb.pop_front();
+        }
+        for(int i = 0; i < size; ++i){
+            cb.push_back(i * 3 % 7);
+        }
+    }
+    template<typename Iterator>
+    void check_range(Iterator first, Iterator last){
+        std::vector<int> expected(first, last);
+        typedef typename gl::segmented_iterator_traits<Iterator>::segment_iterator segment_iterator;
+
+        int segments = 0;
+        std::vector<int> seen;
+        gl::for_each_segment(first, last, [&](segment_iterator __first, segment_iterator __last){
+            assert(__first != __last);
+            ++segments;
+            seen.insert(seen.end(), __first, __last);
+        });
+        assert(segments <= 2 && seen == expected);
+
+        std::vector<int> out;
+        gl::copy(first, last, std::back_inserter(out));
+        assert(out == expected);
+
+        out.assign(expected.size() + 1, 0);
+        assert(gl::transform(first, last, out.begin(), std::negate<int>()) == out.begin() + expected.size());
+        for(std::size_t i = 0; i < expected.size(); ++i){
+            assert(out[i] == -expected[i]);
+        }
+
+        assert(gl::accumulate(first, last, 0) == std::accumulate(expected.begin(), expected.end(), 0));
+        assert(gl::accumulate(first, last, 1, std::multiplies<int>()) ==
+               std::accumulate(expected.begin(), expected.end(), 1, std::multiplies<int>()));
+
+        for(int value = 0; value < 8; ++value){
+            Iterator found = gl::find(first, last, value);
+            std::vector<int>::iterator expected_found = std::find(expected.begin(), expected.end(), value);
+            assert(found - first == expected_found - expected.begin());
+        }
+    }
+    template<typename Buffer>
+    void test_buffer(Buffer& cb){
+        for(int offset = 0; offset < capacity; ++offset){
+            for(int size = 0; size <= capacity; ++size){
+                fill_rotated(cb, offset, size);
+                for(int i = 0; i <= size; ++i){
+                    for(int j = i; j <= size; ++j){
+                        check_range(cb.begin() + i, cb.begin() + j);
+                        const Buffer& const_cb = cb;
+                        check_range(const_cb.begin() + i, const_cb.begin() + j);
+                    }
+                }
+                gl::fill(cb.begin() + size / 2, cb.end(), 9);
+                for(int i = 0; i < size; ++i){
+                    assert(cb[i] == (i < size / 2 ? i * 3 % 7 : 9));
+                }
+            }
+        }
+    }
+    //iterators that are not segmented are one segment and keep using the std:: algorithms
+    void test_plain(){
+        std::vector<int> values = {1, 2, 3};
+        int segments = 0;
+        gl::for_each_segment(values.begin(), values.end(), [&](std::vector<int>::iterator, std::vector<int>::iterator){
+            ++segments;
+        });
+        assert(segments == 1);
+        assert(gl::segmented_iterator_traits<std::vector<int>::iterator>::is_segmented::value == false);
+        using namespace gl;
+        using namespace std;
+        assert(accumulate(values.begin(), values.end(), 0) == 6);
+    }
+}
+
+int main(){
+    gl::circular_buffer<int> cb(capacity);
+    test_buffer(cb);
+    gl::pow2_circular_buffer<int> pow2(capacity);
+    test_buffer(pow2);
+    gl::static_circular_buffer<int, capacity> fixed;
+    test_buffer(fixed);
+    test_plain();
+    std::puts("circular_buffer_algorithm_test passed");
+    return 0;
+}
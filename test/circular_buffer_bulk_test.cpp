@@ -0,0 +1,106 @@
+//circular_buffer bulk push_back/pop_front/insert and copies, through the memcpy paths for
+//trivially copyable elements read from or written to pointers and the element-wise paths otherwise,
+//checked against a std::deque model with overwrite semantics.
+//from the repository root: g++ -std=c++11 -I. test/circular_buffer_bulk_test.cpp && ./a.out
+#undef NDEBUG
+#include "circular_buffer.h"
+#include <cassert>
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    template<typename T>
+    struct model {
+        std::deque<T>   values;
+        std::size_t     capacity;
+
+        template<typename Iterator>
+        void push_back(Iterator first, Iterator last){
+            for(; first != last; ++first){
+                if(capacity == 0){
+                    return;
+                }
+                if(values.size() == capacity){
+                    values.pop_front();
+                }
+                values.push_back(*first);
+            }
+        }
+    };
+    template<typename Buffer, typename T>
+    void check(const Buffer& cb, const model<T>& m){
+        assert(cb.size() == m.values.size());
+        assert(std::equal(cb.begin(), cb.end(), m.values.begin()));
+    }
+
+    template<typename T, typename Make>
+    void test_random(Make make){
+        std::mt19937 random(42);
+        for(std::size_t capacity = 0; capacity <= 9; ++capacity){
+            gl::circular_buffer<T> cb(capacity);
+            model<T> m = {std::deque<T>(), capacity};
+            int next = 0;
+            for(int step = 0; step < 2000; ++step){
+                std::size_t n = random() % (capacity + 4);
+                std::vector<T> values;
+                for(std::size_t i = 0; i < n; ++i){
+                    values.push_back(make(next++));
+                }
+                switch(random() % 5){
+                case 0:{
+                    //pointers: memcpy for trivially copyable T
+                    const T* p = values.data();
+                    assert(cb.push_back(p, p + n) == std::min(n, capacity));
+                    m.push_back(values.begin(), values.end());
+                    break;
+                }
+                case 1:{
+                    std::list<T> list(values.begin(), values.end());
+                    cb.push_back(list.begin(), list.end());
+                    m.push_back(list.begin(), list.end());
+                    break;
+                }
+                case 2:{
+                    std::vector<T> out(n + 1);
+                    std::size_t popped = cb.pop_front(out.data(), n);
+                    assert(popped == std::min(n, m.values.size()));
+                    for(std::size_t i = 0; i < popped; ++i){
+                        assert(out[i] == m.values.front());
+                        m.values.pop_front();
+                    }
+                    break;
+                }
+                case 3:{
+                    std::size_t index = m.values.empty() ? 0 : random() % (m.values.size() + 1);
+                    if(n <= cb.reserve()){
+                        cb.insert(cb.begin() + index, values.data(), values.data() + n);
+                        //libstdc++ 12 std::deque empties an element on an empty range insert in the middle
+                        if(n != 0){
+                            m.values.insert(m.values.begin() + index, values.begin(), values.end());
+                        }
+                    }
+                    break;
+                }
+                default:{
+                    gl::circular_buffer<T> copy(cb);
+                    check(copy, m);
+                    cb = copy;
+                    break;
+                }
+                }
+                check(cb, m);
+            }
+        }
+    }
+}
+
+int main(){
+    test_random<int>([](int i){ return i; });
+    test_random<std::string>([](int i){ return std::string(20, char('a' + i % 26)); });
+    std::puts("circular_buffer_bulk_test passed");
+    return 0;
+}
@@ -0,0 +1,83 @@
+//full-buffer policies and their drop counters.
+//from the repository root: g++ -std=c++11 -I. test/circular_buffer_full_policy_test.cpp && ./a.out
+#undef NDEBUG
+#include "circular_buffer.h"
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+namespace {
+    void test_overwrite(){
+        gl::circular_buffer<int, std::allocator<int>, gl::counted_overwrite_on_full> cb(4);
+        for(int i = 0; i < 7; ++i){
+            assert(cb.push_back(i));
+        }
+        assert(cb.size() == 4 && cb.front() == 3 && cb.back() == 6);
+        assert(cb.overwritten_count() == 3 && cb.rejected_count() == 0);
+        assert(cb.push_front(2));
+        assert(cb.front() == 2 && cb.back() == 5);
+        assert(cb.overwritten_count() == 4);
+
+        //growing keeps the counters, shrinking below size() drops the newest elements
+        cb.set_capacity(8);
+        assert(cb.overwritten_count() == 4);
+        cb.set_capacity(2);
+        assert(cb.size() == 2 && cb.front() == 2 && cb.back() == 3);
+        assert(cb.overwritten_count() == 6);
+
+        std::vector<int> values(5, 9);
+        assert(cb.push_back(values.begin(), values.end()) == 2);
+        assert(cb.overwritten_count() == 11);
+        cb.reset_counters();
+        assert(cb.overwritten_count() == 0);
+    }
+    void test_reject(){
+        gl::circular_buffer<int, std::allocator<int>, gl::counted_reject_on_full> cb(2);
+        assert(cb.push_back(1));
+        assert(cb.push_back(2));
+        assert(!cb.push_back(3));
+        assert(!cb.push_front(0));
+        assert(cb.front() == 1 && cb.back() == 2);
+        assert(cb.rejected_count() == 2 && cb.overwritten_count() == 0);
+
+        cb.set_capacity(4);
+        assert(cb.rejected_count() == 2);
+        std::vector<int> values(3, 7);
+        assert(cb.push_back(values.begin(), values.end()) == 2);
+        assert(cb.size() == 4 && cb.rejected_count() == 3);
+    }
+    void test_grow(){
+        gl::circular_buffer<int, std::allocator<int>, gl::grow_on_full> cb(2);
+        for(int i = 0; i < 9; ++i){
+            assert(cb.push_back(i));
+        }
+        assert(cb.size() == 9 && cb.capacity() >= 9);
+        for(int i = 0; i < 9; ++i){
+            assert(cb[i] == i);
+        }
+        assert(cb.overwritten_count() == 0 && cb.rejected_count() == 0);
+    }
+    void test_zero_capacity(){
+        gl::circular_buffer<int, std::allocator<int>, gl::counted_overwrite_on_full> cb(0);
+        assert(!cb.push_back(1));
+        assert(cb.empty());
+        assert(cb.rejected_count() == 1 && cb.overwritten_count() == 0);
+    }
+    void test_swap(){
+        gl::circular_buffer<int, std::allocator<int>, gl::counted_overwrite_on_full> a(1), b(1);
+        a.push_back(1);
+        a.push_back(2);
+        a.swap(b);
+        assert(a.overwritten_count() == 0 && b.overwritten_count() == 1);
+    }
+}
+
+int main(){
+    test_overwrite();
+    test_reject();
+    test_grow();
+    test_zero_capacity();
+    test_swap();
+    std::puts("circular_buffer_full_policy_test passed");
+    return 0;
+}
@@ -0,0 +1,116 @@
+//circular_buffer middle insert and erase at every position and rotation, checked against a
+//std::deque model, and that only the shorter side of the edit point is relocated.
+//from the repository root: g++ -std=c++11 -I. test/circular_buffer_middle_test.cpp && ./a.out
+#undef NDEBUG
+#include "circular_buffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <deque>
+#include <string>
+
+namespace {
+    const int capacity = 7;
+
+    template<typename T, typename Make>
+    void fill_rotated(gl::circular_buffer<T>& cb, std::deque<T>& model, int offset, int size, Make make){
+        cb.clear();
+        model.clear();
+        for(int i = 0; i < offset; ++i){
+            cb.push_back(make(-1));
+            cb.pop_front();
+        }
+        for(int i = 0; i < size; ++i){
+            cb.push_back(make(i));
+            model.push_back(make(i));
+        }
+    }
+    template<typename T>
+    void check(const gl::circular_buffer<T>& cb, const std::deque<T>& model){
+        assert(cb.size() == model.size());
+        assert(std::equal(cb.begin(), cb.end(), model.begin()));
+    }
+
+    template<typename T, typename Make>
+    void test_erase(Make make){
+        gl::circular_buffer<T> cb(capacity);
+        std::deque<T> model;
+        for(int offset = 0; offset < capacity; ++offset){
+            for(int size = 0; size <= capacity; ++size){
+                for(int index = 0; index <= size; ++index){
+                    for(int n = 0; index + n <= size; ++n){
+                        fill_rotated(cb, model, offset, size, make);
+                        const T* front = size ? &cb.front() : nullptr;
+                        const T* back = size ? &cb.back() : nullptr;
+                        typename gl::circular_buffer<T>::iterator next = cb.erase(cb.begin() + index, cb.begin() + index + n);
+                        model.erase(model.begin() + index, model.begin() + index + n);
+                        check(cb, model);
+                        assert(next == cb.begin() + index);
+                        //the shorter side moved over the gap, the other one stayed in place
+                        int tail = size - index - n;
+                        if(n != 0 && index != 0 && tail != 0){
+                            assert(index < tail ? back == &cb.back() : front == &cb.front());
+                        }
+                    }
+                }
+            }
+        }
+    }
+    template<typename T, typename Make>
+    void test_insert(Make make){
+        gl::circular_buffer<T> cb(capacity);
+        std::deque<T> model;
+        for(int offset = 0; offset < capacity; ++offset){
+            for(int size = 0; size < capacity; ++size){
+                for(int index = 0; index <= size; ++index){
+                    fill_rotated(cb, model, offset, size, make);
+                    const T* front = size ? &cb.front() : nullptr;
+                    const T* back = size ? &cb.back() : nullptr;
+                    typename gl::circular_buffer<T>::iterator p = cb.insert(cb.begin() + index, make(100));
+                    model.insert(model.begin() + index, make(100));
+                    check(cb, model);
+                    assert(*p == make(100) && p == cb.begin() + index);
+                    if(index != 0 && index != size){
+                        assert(index < size - index ? back == &cb.back() : front == &cb.front());
+                    }
+
+                    //n copies, sized to the space left
+                    int n = std::min(3, capacity - (int)cb.size());
+                    int middle = index / 2;
+                    cb.insert(cb.begin() + middle, n, make(200));
+                    //libstdc++ 12 std::deque mishandles an empty insert in the middle
+                    if(n != 0){
+                        model.insert(model.begin() + middle, n, make(200));
+                    }
+                    check(cb, model);
+                }
+            }
+        }
+    }
+    //inserting into a full buffer drops the oldest elements, the ones before the insert point first
+    template<typename T, typename Make>
+    void test_insert_full(Make make){
+        for(int index = 0; index <= capacity; ++index){
+            gl::circular_buffer<T> cb(capacity);
+            std::deque<T> model;
+            fill_rotated(cb, model, 3, capacity, make);
+            cb.insert(cb.begin() + index, make(100));
+            if(index != 0){
+                model.pop_front();
+                model.insert(model.begin() + index - 1, make(100));
+            }
+            check(cb, model);
+        }
+    }
+}
+
+int main(){
+    test_erase<int>([](int i){ return i; });
+    test_erase<std::string>([](int i){ return std::string(20, char('a' + (i + 26) % 26)); });
+    test_insert<int>([](int i){ return i; });
+    test_insert<std::string>([](int i){ return std::string(20, char('a' + (i + 26) % 26)); });
+    test_insert_full<int>([](int i){ return i; });
+    test_insert_full<std::string>([](int i){ return std::string(20, char('a' + (i + 26) % 26)); });
+    std::puts("circular_buffer_middle_test passed");
+    return 0;
+}
@@ -0,0 +1,77 @@
+//circular_buffer segment access (array_one/array_two) and in-place linearize().
+//from the repository root: g++ -std=c++11 -I. test/circular_buffer_segments_test.cpp && ./a.out
+#undef NDEBUG
+#include "circular_buffer.h"
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    template<typename Buffer>
+    std::vector<typename Buffer::value_type> segments(const Buffer& cb){
+        typename Buffer::const_array_range one = cb.array_one();
+        typename Buffer::const_array_range two = cb.array_two();
+        std::vector<typename Buffer::value_type> values(one.first, one.first + one.second);
+        values.insert(values.end(), two.first, two.first + two.second);
+        return values;
+    }
+    template<typename Buffer>
+    std::vector<typename Buffer::value_type> elements(const Buffer& cb){
+        return std::vector<typename Buffer::value_type>(cb.begin(), cb.end());
+    }
+
+    void test_segments(){
+        gl::circular_buffer<int> cb(5);
+        assert(cb.array_one().second == 0 && cb.array_two().second == 0);
+        for(int i = 0; i < 4; ++i){
+            cb.push_back(i);
+        }
+        assert(cb.is_linearized());
+        assert(cb.array_one().second == 4 && cb.array_two().second == 0);
+        cb.pop_front();
+        cb.pop_front();
+        cb.push_back(4);
+        cb.push_back(5);
+        cb.push_back(6);
+        assert(!cb.is_linearized());
+        assert(cb.array_one().second + cb.array_two().second == cb.size());
+        assert(cb.array_one().first == &cb.front());
+        assert(cb.array_two().first + cb.array_two().second - 1 == &cb.back());
+        assert(segments(cb) == elements(cb));
+    }
+    //every rotation of the ring, for trivially copyable and non-trivial elements
+    template<typename T, typename Make>
+    void test_linearize(Make make){
+        for(int capacity = 1; capacity <= 7; ++capacity){
+            for(int size = 0; size <= capacity; ++size){
+                for(int offset = 0; offset <= capacity; ++offset){
+                    gl::circular_buffer<T> cb(capacity);
+                    for(int i = 0; i < offset; ++i){
+                        cb.push_back(make(-1));
+                        cb.pop_front();
+                    }
+                    for(int i = 0; i < size; ++i){
+                        cb.push_back(make(i));
+                    }
+                    std::vector<T> before = elements(cb);
+                    T* p = cb.linearize();
+                    assert(cb.is_linearized());
+                    assert(cb.array_two().second == 0);
+                    assert(elements(cb) == before);
+                    assert(size == 0 || p == &cb.front());
+                    cb.push_back(make(size));
+                    assert(cb.back() == make(size));
+                }
+            }
+        }
+    }
+}
+
+int main(){
+    test_segments();
+    test_linearize<int>([](int i){ return i; });
+    test_linearize<std::string>([](int i){ return std::string(24, char('a' + (i + 26) % 26)); });
+    std::puts("circular_buffer_segments_test passed");
+    return 0;
+}
@@ -0,0 +1,91 @@
+//circular_buffer_space_optimized: lazy growth, shrinking and circular_buffer compatible results.
+//from the repository root: g++ -std=c++11 -I. test/circular_buffer_space_optimized_test.cpp && ./a.out
+#undef NDEBUG
+#include "circular_buffer_space_optimized.h"
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef gl::circular_buffer_space_optimized<int> buffer_type;
+
+    void test_lazy_growth(){
+        buffer_type cb(100);
+        assert(cb.capacity() == 100 && cb.allocated_capacity() == 0);
+        assert(cb.push_back(0));
+        std::size_t allocated = cb.allocated_capacity();
+        assert(allocated >= 1 && allocated < 100);
+        for(int i = 1; i < 100; ++i){
+            assert(cb.push_back(i));
+            assert(cb.allocated_capacity() >= cb.size());
+            assert(cb.allocated_capacity() >= allocated);
+            allocated = cb.allocated_capacity();
+        }
+        assert(cb.full() && cb.allocated_capacity() == 100);
+        //full: the oldest element is overwritten, the storage stays
+        assert(cb.push_back(100));
+        assert(cb.front() == 1 && cb.back() == 100 && cb.allocated_capacity() == 100);
+        assert(cb.push_front(0));
+        assert(cb.front() == 0 && cb.back() == 99);
+    }
+    void test_shrink(){
+        buffer_type cb(64, 4);
+        for(int i = 0; i < 64; ++i){
+            cb.push_back(i);
+        }
+        while(cb.size() > 8){
+            cb.pop_front();
+        }
+        assert(cb.allocated_capacity() < 64 && cb.allocated_capacity() >= 8);
+        assert(cb.front() == 56 && cb.back() == 63);
+        cb.clear();
+        assert(cb.allocated_capacity() == 4);
+
+        gl::circular_buffer_space_optimized<int> never(64, 0, gl::space_optimized_shrink_policy(0));
+        for(int i = 0; i < 64; ++i){
+            never.push_back(i);
+        }
+        never.clear();
+        assert(never.allocated_capacity() == 64);
+        never.shrink_to_fit();
+        assert(never.allocated_capacity() == 0);
+    }
+    void test_results(){
+        buffer_type none(0);
+        assert(!none.push_back(1));
+        assert(!none.push_front(1));
+        assert(!none.emplace_back(1));
+        assert(none.empty());
+
+        buffer_type cb(4);
+        std::vector<int> values(6, 7);
+        assert(cb.push_back(values.begin(), values.end()) == 4);
+        assert(cb.size() == 4);
+
+        gl::circular_buffer_space_optimized<std::string> strings(3);
+        assert(strings.emplace_back(2, 'a'));
+        assert(strings.emplace_front("b"));
+        assert(strings.front() == "b" && strings.back() == "aa");
+    }
+    void test_set_capacity(){
+        buffer_type cb(16);
+        for(int i = 0; i < 10; ++i){
+            cb.push_back(i);
+        }
+        cb.set_capacity(4);
+        assert(cb.capacity() == 4 && cb.size() == 4 && cb.allocated_capacity() == 4);
+        assert(cb.front() == 0 && cb.back() == 3);
+        cb.insert(cb.begin() + 1, 42);
+        assert(cb.size() == 4 && cb[0] == 42);
+    }
+}
+
+int main(){
+    test_lazy_growth();
+    test_shrink();
+    test_results();
+    test_set_capacity();
+    std::puts("circular_buffer_space_optimized_test passed");
+    return 0;
+}
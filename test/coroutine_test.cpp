@@ -0,0 +1,157 @@
+//co_await async_pop_front/async_push_back on sync_deque. needs C++20 coroutines.
+//from the repository root: g++ -std=c++20 -pthread -I. test/coroutine_test.cpp && ./a.out
+#undef NDEBUG
+#include "sync_deque.h"
+#include <cassert>
+#include <cstdio>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if GL_HAS_COROUTINES
+namespace {
+    struct task {
+        struct promise_type {
+            task get_return_object(){
+                return task();
+            }
+            std::suspend_never initial_suspend(){
+                return {};
+            }
+            std::suspend_never final_suspend() noexcept {
+                return {};
+            }
+            void return_void(){
+            }
+            void unhandled_exception(){
+                std::terminate();
+            }
+        };
+    };
+
+    //collects coroutines to resume later, on whichever thread calls run_one()
+    class deferred_executor {
+    public:
+        void operator()(std::coroutine_handle<> handle) const {
+            std::lock_guard<std::mutex> lock(d_state->mutex);
+            d_state->handles.push_back(handle);
+        }
+        bool run_one() const {
+            std::coroutine_handle<> handle;
+            {
+                std::lock_guard<std::mutex> lock(d_state->mutex);
+                if(d_state->handles.empty()){
+                    return false;
+                }
+                handle = d_state->handles.front();
+                d_state->handles.pop_front();
+            }
+            handle.resume();
+            return true;
+        }
+    private:
+        struct state {
+            std::mutex                              mutex;
+            std::deque<std::coroutine_handle<>>     handles;
+        };
+        std::shared_ptr<state> d_state = std::make_shared<state>();
+    };
+
+    template<typename Queue, typename Executor>
+    task consume(Queue& q, int n, Executor executor, std::atomic<long>& sum){
+        for(int i = 0; i < n; ++i){
+            sum += co_await q.async_pop_front(executor);
+        }
+    }
+    template<typename Queue>
+    task produce(Queue& q, int first, int last){
+        for(int i = first; i <= last; ++i){
+            co_await q.async_push_back(i);
+        }
+    }
+    template<typename Queue>
+    task consume_string(Queue& q, std::string& out){
+        out = co_await q.async_pop_front();
+    }
+
+    //suspended consumers are resumed inline by the pushing thread
+    void test_inline(){
+        gl::sync_deque<long> q(4);
+        std::atomic<long> sum(0);
+        for(int i = 0; i < 100; ++i){
+            consume(q, 10, gl::inline_executor(), sum);
+        }
+        for(long i = 1; i <= 1000; ++i){
+            q.push_back(i);
+        }
+        assert(sum.load() == 1000L * 1001 / 2);
+        assert(q.empty());
+
+        gl::sync_deque<std::string> s(1);
+        std::string a, b;
+        consume_string(s, a);
+        consume_string(s, b);
+        s.push_back(std::string("x"));
+        s.push_back(std::string("y"));
+        assert(a == "x" && b == "y");
+    }
+    //producers suspended on a full queue are completed by popping threads
+    void test_suspended_producers(){
+        gl::sync_deque<long> q(2);
+        for(int i = 0; i < 10; ++i){
+            produce(q, i * 5 + 1, i * 5 + 5);
+        }
+        long sum = 0;
+        for(int i = 0; i < 50; ++i){
+            sum += q.pop_front();
+        }
+        assert(sum == 50L * 51 / 2);
+        assert(q.empty());
+    }
+    //the element moves, the other side is notified and the stats are recorded before the
+    //executor resumes the coroutine, so an executor that is slow or never runs it holds nothing up
+    void test_completion_before_resume(){
+        typedef gl::sync_deque<long, true, std::allocator<long>, gl::locked_backend, gl::park_wait, true> queue_type;
+        deferred_executor executor;
+        std::atomic<long> sum(0);
+        queue_type q(1);
+        consume(q, 2, executor, sum);
+        q.push_back(7);
+        assert(q.empty());
+        assert(q.stats().pushed == 1 && q.stats().popped == 1);
+        assert(sum.load() == 0);
+        assert(executor.run_one());
+        assert(sum.load() == 7);
+
+        //the coroutine waits again, a thread's pushes complete it and the queue drains
+        std::thread producer([&]{
+            q.push_back(8);
+            q.push_back(9);
+        });
+        while(q.stats().popped != 2){
+            std::this_thread::yield();
+        }
+        assert(q.pop_front() == 9);
+        producer.join();
+        assert(executor.run_one());
+        assert(sum.load() == 15);
+        assert(q.stats().pushed == 3 && q.stats().popped == 3);
+    }
+}
+#endif
+
+int main(){
+#if GL_HAS_COROUTINES
+    test_inline();
+    test_suspended_producers();
+    test_completion_before_resume();
+    std::puts("coroutine_test passed");
+#else
+    std::puts("coroutine_test skipped, no C++20 coroutines");
+#endif
+    return 0;
+}
@@ -0,0 +1,135 @@
+//sync_deque with elastic_capacity: growing from min up to max under a burst, keeping the elements
+//in order across resizes, shrinking back to min once idle, and a producer against several consumers.
+//from the repository root: g++ -std=c++14 -pthread -I. test/elastic_sync_deque_test.cpp && ./a.out
+#include "sync_deque.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <chrono>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef gl::sync_deque<int, true, std::allocator<int>, gl::locked_backend, gl::park_wait, true> queue_type;
+
+    //waits up to a second for a blocked consumer to shrink q down to capacity
+    template<typename Queue>
+    bool wait_for_capacity(const Queue& q, std::size_t capacity){
+        for(int i = 0; i < 1000 && q.capacity() != capacity; ++i){
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return q.capacity() == capacity;
+    }
+    //a push that finds the ring full doubles it, up to max, after which pushes block again
+    void test_grow(){
+        queue_type q(gl::elastic_capacity(4, 32, std::chrono::seconds(10)));
+        assert(q.capacity() == 4);
+        for(int i = 0; i < 4; ++i){
+            q.push_back(i);
+        }
+        assert(q.capacity() == 4 && q.stats().grows == 0);
+        q.push_back(4);
+        assert(q.capacity() == 8 && q.stats().grows == 1);
+        for(int i = 5; i < 32; ++i){
+            assert(q.try_push(i));
+        }
+        assert(q.capacity() == 32 && q.stats().grows == 3);
+        assert(!q.try_push(32) && !q.push_for(std::chrono::milliseconds(1), 32));
+        assert(q.capacity() == 32 && q.size() == 32);
+        for(int i = 0; i < 32; ++i){
+            assert(q.pop_front() == i);
+        }
+
+        //a bulk push grows straight to a capacity that holds the whole range
+        queue_type bulk(gl::elastic_capacity(2, 64, std::chrono::seconds(10)));
+        std::vector<int> values(20);
+        for(int i = 0; i < 20; ++i){
+            values[i] = i;
+        }
+        bulk.push_back_bulk(values.begin(), values.end());
+        assert(bulk.capacity() == 32 && bulk.stats().grows == 1);
+        std::vector<int> out;
+        assert(bulk.pop_front_bulk(std::back_inserter(out), 64) == 20 && out == values);
+
+        //min equal to max is a fixed capacity
+        queue_type fixed(gl::elastic_capacity(4, 4));
+        for(int i = 0; i < 4; ++i){
+            fixed.push_back(i);
+        }
+        assert(!fixed.try_push(4) && fixed.capacity() == 4);
+        assert(!fixed.shrink_to_fit_if_idle());
+    }
+    //a ring that wrapped keeps its order when it grows
+    void test_grow_wrapped(){
+        gl::sync_deque<std::string> q(gl::elastic_capacity(4, 16, std::chrono::seconds(10)));
+        for(int i = 0; i < 3; ++i){
+            q.push_back(std::string(20, char('a' + i)));
+        }
+        assert(q.pop_front() == std::string(20, 'a') && q.pop_front() == std::string(20, 'b'));
+        for(int i = 3; i < 10; ++i){
+            q.push_back(std::string(20, char('a' + i)));
+        }
+        assert(q.capacity() == 8 && q.size() == 8);
+        for(int i = 2; i < 10; ++i){
+            assert(q.pop_front() == std::string(20, char('a' + i)));
+        }
+        //elements still queued are destroyed with the queue
+        q.push_back(std::string(32, 'x'));
+    }
+    //an idle ring is halved once per idle interval, never below min and never while busy
+    void test_shrink(){
+        queue_type q(gl::elastic_capacity(2, 16, std::chrono::milliseconds(1)));
+        for(int i = 0; i < 16; ++i){
+            q.push_back(i);
+        }
+        assert(q.capacity() == 16);
+        //more than a quarter full: never idle
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        assert(!q.shrink_to_fit_if_idle() && !q.shrink_to_fit_if_idle());
+        for(int i = 0; i < 16; ++i){
+            q.pop_front();
+        }
+        //the first check after the ring was busy only starts the idle interval
+        assert(!q.shrink_to_fit_if_idle());
+        std::size_t expected = 16;
+        while(expected > 2){
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            assert(q.shrink_to_fit_if_idle());
+            expected /= 2;
+            assert(q.capacity() == expected);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        assert(!q.shrink_to_fit_if_idle() && q.capacity() == 2);
+        assert(q.stats().shrinks == 3);
+
+        //a consumer blocked on the empty queue shrinks it by itself
+        for(int i = 0; i < 16; ++i){
+            q.push_back(i);
+        }
+        for(int i = 0; i < 16; ++i){
+            q.pop_front();
+        }
+        assert(q.capacity() == 16);
+        int value = -1;
+        std::thread consumer([&]{ value = q.pop_front(); });
+        assert(wait_for_capacity(q, 2));
+        q.push_back(7);
+        consumer.join();
+        assert(value == 7 && q.capacity() == 2);
+    }
+    void test_threads(){
+        gl::sync_deque<long> q(gl::elastic_capacity(8, 1024, std::chrono::milliseconds(1)));
+        gl_test::run_spmc(20000, 3, [&](long v){ q.push_back(v); },
+                          [&](long& v){ return q.pop_for(v, std::chrono::milliseconds(1)); });
+        assert(q.capacity() >= 8 && q.capacity() <= 1024);
+    }
+}
+
+int main(){
+    test_grow();
+    test_grow_wrapped();
+    test_shrink();
+    test_threads();
+    std::puts("elastic_sync_deque_test passed");
+    return 0;
+}
@@ -0,0 +1,102 @@
+//sync_deque with eventfd_wait, driven from poll() as an epoll loop would and from blocked threads.
+//from the repository root: g++ -std=c++14 -pthread -I. test/eventfd_wait_test.cpp && ./a.out
+#undef NDEBUG
+#include "sync_deque.h"
+#include "eventfd_wait.h"
+#include <cassert>
+#include <cstdio>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <poll.h>
+
+namespace {
+    typedef gl::sync_deque<int, true, std::allocator<int>, gl::locked_backend, gl::eventfd_wait> queue_type;
+
+    bool readable(int fd, int timeout_ms){
+        pollfd p;
+        p.fd = fd;
+        p.events = POLLIN;
+        p.revents = 0;
+        return ::poll(&p, 1, timeout_ms) == 1 && (p.revents & POLLIN);
+    }
+
+    //elements pushed before anyone asked for the descriptor still make it readable
+    void test_push_before_native_handle(){
+        queue_type q(16);
+        q.push_back(1);
+        q.push_back(2);
+        int fd = q.native_handle();
+        assert(readable(fd, 100));
+        int out[16];
+        assert(q.drain_front(out, 16) == 2);
+        assert(out[0] == 1 && out[1] == 2);
+        assert(!readable(fd, 0));
+    }
+    void test_readiness(){
+        queue_type q(16);
+        int fd = q.native_handle();
+        int out[16];
+        q.drain_front(out, 16);
+        assert(!readable(fd, 0));
+
+        q.push_back(3);
+        q.push_back(4);
+        assert(readable(fd, 100));
+        //a partial drain leaves it readable
+        assert(q.drain_front(out, 1) == 1 && out[0] == 3);
+        assert(readable(fd, 0));
+        assert(q.drain_front(out, 16) == 1 && out[0] == 4);
+        assert(!readable(fd, 0));
+        assert(q.drain_front(out, 16) == 0);
+    }
+    //one producer, a poll() loop consumer and two threads blocked in pop_for
+    void test_spmc(){
+        const int items = 20000;
+        queue_type q(64);
+        int fd = q.native_handle();
+        std::atomic<int> taken(0);
+        std::atomic<long> sum(0);
+        std::vector<std::thread> threads;
+        threads.emplace_back([&]{
+            int out[16];
+            while(taken.load() < items){
+                if(readable(fd, 1)){
+                    int n = static_cast<int>(q.drain_front(out, 16));
+                    for(int i = 0; i < n; ++i){
+                        sum += out[i];
+                    }
+                    taken += n;
+                }
+            }
+        });
+        for(int i = 0; i < 2; ++i){
+            threads.emplace_back([&]{
+                int value;
+                while(taken.load() < items){
+                    if(q.pop_for(value, std::chrono::milliseconds(1))){
+                        sum += value;
+                        ++taken;
+                    }
+                }
+            });
+        }
+        for(int i = 1; i <= items; ++i){
+            q.push_back(i);
+        }
+        for(auto& t : threads){
+            t.join();
+        }
+        assert(taken.load() == items);
+        assert(sum.load() == (long)items * (items + 1) / 2);
+    }
+}
+
+int main(){
+    test_push_before_native_handle();
+    test_readiness();
+    test_spmc();
+    std::puts("eventfd_wait_test passed");
+    return 0;
+}
@@ -0,0 +1,86 @@
+//huge_page_allocator: which allocations are mapped, mapping alignment and use as container storage.
+//from the repository root: g++ -std=c++11 -I. test/huge_page_allocator_test.cpp && ./a.out
+#undef NDEBUG
+#include "huge_page_allocator.h"
+#include "circular_buffer.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace {
+    std::size_t new_calls = 0;
+}
+void* operator new(std::size_t n){
+    ++new_calls;
+    void* p = std::malloc(n == 0 ? 1 : n);
+    if(p == nullptr){
+        throw std::bad_alloc();
+    }
+    return p;
+}
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+    bool aligned_to(const void* p, std::size_t alignment){
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    }
+    //small allocations, as from a rebound allocator, go to operator new by default
+    void test_small_allocations(){
+        gl::huge_page_allocator<double> alloc;
+        gl::huge_page_allocator<double>::rebind<char>::other small(alloc);
+        std::size_t before = new_calls;
+        char* p = small.allocate(8);
+        assert(new_calls == before + 1);
+        small.deallocate(p, 8);
+
+        gl::huge_page_options all(gl::huge_page_transparent, gl::numa_first_touch, false, 0);
+        gl::huge_page_allocator<char> mapped(all);
+        before = new_calls;
+        p = mapped.allocate(8);
+        assert(new_calls == before);
+        assert(aligned_to(p, all.huge_page_size));
+        mapped.deallocate(p, 8);
+    }
+    void test_large_allocations(){
+        const std::size_t n = 3 * gl::default_huge_page_size / sizeof(int);
+        gl::huge_page_mode modes[] = {gl::huge_page_none, gl::huge_page_transparent, gl::huge_page_explicit};
+        for(gl::huge_page_mode mode : modes){
+            gl::huge_page_allocator<int> alloc(gl::huge_page_options(mode, gl::numa_first_touch, true));
+            std::size_t before = new_calls;
+            int* p = alloc.allocate(n);
+            assert(new_calls == before);
+            if(mode != gl::huge_page_none){
+                assert(aligned_to(p, gl::default_huge_page_size));
+            }
+            std::memset(p, 1, n * sizeof(int));
+            assert(p[n - 1] == 0x01010101);
+            alloc.deallocate(p, n);
+        }
+    }
+    void test_container(){
+        typedef gl::huge_page_allocator<int> alloc_type;
+        gl::circular_buffer<int, alloc_type> cb(gl::default_huge_page_size, alloc_type(gl::huge_page_options(gl::huge_page_transparent)));
+        for(int i = 0; i < 1000; ++i){
+            cb.push_back(i);
+        }
+        assert(cb.size() == 1000 && cb.front() == 0 && cb.back() == 999);
+        assert(cb.get_allocator() == alloc_type());
+        assert(cb.get_allocator() != alloc_type(gl::huge_page_options(gl::huge_page_none)));
+    }
+}
+
+int main(){
+    test_small_allocations();
+    test_large_allocations();
+    test_container();
+    std::puts("huge_page_allocator_test passed");
+    return 0;
+}
@@ -0,0 +1,135 @@
+//message_ring: record framing, padding at the end of a lap, partial commits and one producer
+//thread against one consumer thread.
+//from the repository root: g++ -std=c++14 -pthread -I. test/message_ring_test.cpp && ./a.out
+#include "message_ring.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    static_assert(alignof(gl::message_ring<>) <= alignof(std::max_align_t), "message_ring is over-aligned");
+
+    std::string record(int i){
+        return std::string(i % 61, char('a' + i % 26));
+    }
+    bool read(gl::message_ring<>& ring, std::string& out){
+        gl::message_ring<>::const_array_range r = ring.peek();
+        if(r.first == nullptr){
+            return false;
+        }
+        assert(reinterpret_cast<std::uintptr_t>(r.first) % gl::message_ring<>::record_alignment == 0);
+        out.assign(r.first, r.second);
+        ring.release();
+        return true;
+    }
+    void test_framing(){
+        gl::message_ring<> ring(100);
+        assert(ring.capacity() == 128 && ring.max_record_size() == 56 && ring.empty());
+        std::string out;
+        assert(!read(ring, out));
+
+        //records of every length, the ring kept between half and completely full so the
+        //records keep landing at different offsets and lapping with padding
+        std::deque<std::string> model;
+        int next = 0;
+        for(int step = 0; step < 2000; ++step){
+            std::string r = record(next);
+            if(r.size() <= ring.max_record_size() && ring.try_write(r.data(), r.size())){
+                model.push_back(r);
+                ++next;
+            }else if(r.size() > ring.max_record_size()){
+                ++next;
+            }else{
+                assert(!model.empty());
+            }
+            if(step % 3 == 2 || ring.size() > ring.capacity() / 2){
+                if(read(ring, out)){
+                    assert(!model.empty() && out == model.front());
+                    model.pop_front();
+                }else{
+                    assert(model.empty());
+                }
+            }
+        }
+        while(read(ring, out)){
+            assert(out == model.front());
+            model.pop_front();
+        }
+        assert(model.empty() && ring.empty());
+
+        //the largest record always fits once the ring is empty, whatever the offset
+        std::string large(ring.max_record_size(), 'x');
+        for(int i = 0; i < 20; ++i){
+            assert(ring.try_write("abc", i % 4));
+            assert(read(ring, out) && out == std::string("abc", i % 4));
+            assert(ring.try_write(large.data(), large.size()));
+            assert(read(ring, out) && out == large);
+        }
+        bool thrown = false;
+        try{
+            ring.reserve(ring.max_record_size() + 1);
+        }catch(const std::length_error&){
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    //a reservation may be replaced before it is committed, and committed shorter than reserved
+    void test_partial_commit(){
+        gl::message_ring<> ring(64);
+        char* p = ring.reserve(20);
+        assert(p != nullptr);
+        p = ring.reserve(10);
+        std::memcpy(p, "0123456789", 10);
+        ring.commit(4);
+        assert(ring.size() == 16);
+        std::string out;
+        assert(read(ring, out) && out == "0123");
+        assert(ring.empty());
+        //no room: nothing is reserved
+        assert(ring.try_write("0123456789012345678901", 22));
+        assert(ring.reserve(24) == nullptr);
+        assert(read(ring, out) && out.size() == 22);
+    }
+    //records of 1 to 8 longs, each holding its sequence number
+    void test_threads(){
+        gl::message_ring<> ring(256);
+        gl_test::run_spmc(20000, 1,
+            [&](long v){
+                long record[8];
+                std::size_t n = 1 + v % 8;
+                for(std::size_t i = 0; i < n; ++i){
+                    record[i] = v;
+                }
+                while(!ring.try_write(record, n * sizeof(long))){
+                    std::this_thread::yield();
+                }
+            },
+            [&](long& v){
+                gl::message_ring<>::const_array_range r = ring.peek();
+                if(r.first == nullptr){
+                    return false;
+                }
+                std::memcpy(&v, r.first, sizeof(long));
+                assert(r.second == (1 + v % 8) * sizeof(long));
+                for(std::size_t i = 1; i < r.second / sizeof(long); ++i){
+                    long same;
+                    std::memcpy(&same, r.first + i * sizeof(long), sizeof(long));
+                    assert(same == v);
+                }
+                ring.release();
+                return true;
+            });
+    }
+}
+
+int main(){
+    test_framing();
+    test_partial_commit();
+    test_threads();
+    std::puts("message_ring_test passed");
+    return 0;
+}
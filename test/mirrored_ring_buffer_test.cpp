@@ -0,0 +1,87 @@
+//mirrored_ring_buffer: contiguous access across the wrap point and prepare()/commit() framing.
+//from the repository root: g++ -std=c++11 -I. test/mirrored_ring_buffer_test.cpp && ./a.out
+#undef NDEBUG
+#include "mirrored_ring_buffer.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace {
+    void test_capacity(){
+        gl::mirrored_ring_buffer<int> empty;
+        assert(empty.capacity() == 0 && empty.empty());
+        empty.push_back(1);
+        assert(empty.empty());
+
+        gl::mirrored_ring_buffer<int> ring(10);
+        assert(ring.capacity() >= 10);
+        assert(ring.capacity() * sizeof(int) % ::sysconf(_SC_PAGESIZE) == 0);
+    }
+    //once the elements wrap past the end of the storage they are still one contiguous run
+    void test_wrap(){
+        gl::mirrored_ring_buffer<int> ring(1);
+        const int n = static_cast<int>(ring.capacity());
+        for(int i = 0; i < n + n / 2; ++i){
+            ring.push_back(i);
+        }
+        assert(ring.full());
+        assert(ring.front() == n / 2 && ring.back() == n + n / 2 - 1);
+        assert(ring.end() - ring.begin() == n);
+        assert(ring.array_one().second == static_cast<std::size_t>(n) && ring.array_two().second == 0);
+        for(int i = 0; i < n; ++i){
+            assert(ring.data()[i] == n / 2 + i);
+        }
+        assert(std::accumulate(ring.begin(), ring.end(), 0L) == std::accumulate(ring.rbegin(), ring.rend(), 0L));
+
+        ring.push_front(-1);
+        assert(ring.front() == -1 && ring.back() == n + n / 2 - 2);
+        ring.pop_back();
+        ring.pop_front();
+        assert(ring.size() == static_cast<std::size_t>(n - 2));
+    }
+    //reads of arbitrary length land contiguously even when they straddle the wrap point
+    void test_prepare_commit(){
+        gl::mirrored_ring_buffer<char> ring(1);
+        const std::size_t n = ring.capacity();
+        std::vector<char> source(n * 3);
+        for(std::size_t i = 0; i < source.size(); ++i){
+            source[i] = static_cast<char>(i * 7);
+        }
+        std::size_t written = 0, read = 0, chunk = n / 3 + 5;
+        while(read < source.size()){
+            gl::mirrored_ring_buffer<char>::array_range space = ring.prepare();
+            std::size_t k = std::min(std::min(space.second, chunk), source.size() - written);
+            std::memcpy(space.first, &source[written], k);
+            ring.commit(k);
+            written += k;
+            std::size_t m = std::min(ring.size(), chunk / 2 + 1);
+            assert(std::memcmp(ring.data(), &source[read], m) == 0);
+            ring.consume(m);
+            read += m;
+        }
+        assert(ring.empty() && written == source.size());
+    }
+    void test_bulk(){
+        gl::mirrored_ring_buffer<int> ring(1);
+        const std::size_t n = ring.capacity();
+        std::vector<int> values(n + 3);
+        std::iota(values.begin(), values.end(), 0);
+        ring.push_back(values.begin(), values.end());
+        assert(ring.size() == n && ring.front() == 3);
+        std::vector<int> out(n);
+        assert(ring.pop_front(out.begin(), n + 1) == n);
+        assert(out.front() == 3 && out.back() == static_cast<int>(n + 2));
+        assert(ring.empty());
+    }
+}
+
+int main(){
+    test_capacity();
+    test_wrap();
+    test_prepare_commit();
+    test_bulk();
+    std::puts("mirrored_ring_buffer_test passed");
+    return 0;
+}
@@ -0,0 +1,86 @@
+//mpmc_queue, on its own and as the sync_deque mpmc_backend.
+//from the repository root: g++ -std=c++14 -pthread -I. test/mpmc_queue_test.cpp && ./a.out
+#include "mpmc_queue.h"
+#include "sync_deque.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <cstddef>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace {
+    typedef gl::sync_deque<long, true, std::allocator<long>, gl::mpmc_backend> queue_type;
+
+    static_assert(alignof(gl::mpmc_queue<long>) <= alignof(std::max_align_t), "mpmc_queue is over-aligned");
+    static_assert(alignof(queue_type) <= alignof(std::max_align_t), "sync_deque with mpmc_backend is over-aligned");
+
+    void test_fifo(){
+        gl::mpmc_queue<std::string> q(4);
+        assert(q.capacity() == 4 && q.empty());
+        for(int i = 0; i < 4; ++i){
+            assert(q.try_push(std::string(20, char('a' + i))));
+        }
+        assert(q.full() && !q.try_push(std::string("e")));
+        std::string value;
+        for(int i = 0; i < 4; ++i){
+            assert(q.try_pop(value) && value == std::string(20, char('a' + i)));
+        }
+        assert(!q.try_pop(value) && q.empty());
+        //elements still queued are destroyed with the queue
+        q.try_push(std::string(32, 'x'));
+    }
+    //a capacity under 2 is raised to 2 and reported as such
+    void test_minimum_capacity(){
+        gl::mpmc_queue<int> q(1);
+        assert(q.capacity() == 2);
+        assert(q.try_push(1) && q.try_push(2) && !q.try_push(3));
+
+        queue_type d(1);
+        assert(d.capacity() == 2);
+        assert(d.try_push(1) && d.try_push(2) && !d.try_push(3));
+        assert(!d.push_for(std::chrono::milliseconds(1), 3));
+        long value;
+        assert(d.try_pop(value) && value == 1);
+    }
+    void test_spmc(){
+        gl::mpmc_queue<long> q(64);
+        gl_test::run_spmc(20000, 3, [&](long v){ while(!q.try_push(v)){ std::this_thread::yield(); } },
+                          [&](long& v){ return q.try_pop(v); });
+        queue_type d(64);
+        gl_test::run_spmc(20000, 3, [&](long v){ d.push_back(v); },
+                          [&](long& v){ return d.pop_for(v, std::chrono::milliseconds(1)); });
+    }
+    void test_mpmc(){
+        const long per_producer = 10000;
+        queue_type q(16);
+        std::atomic<long> sum(0);
+        std::vector<std::thread> threads;
+        for(int i = 0; i < 3; ++i){
+            threads.emplace_back([&]{
+                for(long v = 1; v <= per_producer; ++v){
+                    q.push_back(v);
+                }
+            });
+            threads.emplace_back([&]{
+                for(long n = 0; n < per_producer; ++n){
+                    sum += q.pop_front();
+                }
+            });
+        }
+        for(auto& t : threads){
+            t.join();
+        }
+        assert(sum.load() == 3 * per_producer * (per_producer + 1) / 2);
+        assert(q.empty());
+    }
+}
+
+int main(){
+    test_fifo();
+    test_minimum_capacity();
+    test_spmc();
+    test_mpmc();
+    std::puts("mpmc_queue_test passed");
+    return 0;
+}
@@ -0,0 +1,111 @@
+//pow2_circular_buffer: rounded capacity, masked indexing and overwrite at both ends.
+//from the repository root: g++ -std=c++11 -I. test/pow2_circular_buffer_test.cpp && ./a.out
+#undef NDEBUG
+#include "pow2_circular_buffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <deque>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef gl::pow2_circular_buffer<int> buffer_type;
+
+    void test_capacity(){
+        assert(buffer_type().capacity() == 0);
+        assert(buffer_type(0).capacity() == 0);
+        assert(buffer_type(1).capacity() == 1);
+        assert(buffer_type(5).capacity() == 8);
+        assert(buffer_type(8).capacity() == 8);
+        assert(buffer_type(9).capacity() == 16);
+        buffer_type none(0);
+        none.push_back(1);
+        none.push_front(1);
+        assert(none.empty());
+        bool thrown = false;
+        try{
+            buffer_type huge(std::numeric_limits<std::size_t>::max());
+        }catch(const std::length_error&){
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    //the counters run past the capacity many times over, slots are found by masking
+    void test_overwrite(){
+        buffer_type cb(3);
+        std::deque<int> model;
+        for(int i = 0; i < 100; ++i){
+            if(i % 7 == 3){
+                cb.push_front(i);
+                if(model.size() == cb.capacity()){
+                    model.pop_back();
+                }
+                model.push_front(i);
+            }else{
+                cb.push_back(i);
+                if(model.size() == cb.capacity()){
+                    model.pop_front();
+                }
+                model.push_back(i);
+            }
+            if(i % 5 == 4){
+                cb.pop_front();
+                model.pop_front();
+            }
+            assert(cb.size() == model.size() && cb.full() == (cb.size() == 4));
+            assert(std::equal(cb.begin(), cb.end(), model.begin()));
+            assert(std::equal(cb.rbegin(), cb.rend(), model.rbegin()));
+            for(std::size_t j = 0; j < model.size(); ++j){
+                assert(cb[j] == model[j] && cb.begin()[j] == model[j]);
+            }
+            assert(cb.end() - cb.begin() == (std::ptrdiff_t)model.size());
+            assert(cb.array_one().second + cb.array_two().second == cb.size());
+            std::vector<int> segments(cb.array_one().first, cb.array_one().first + cb.array_one().second);
+            segments.insert(segments.end(), cb.array_two().first, cb.array_two().first + cb.array_two().second);
+            assert(std::equal(segments.begin(), segments.end(), model.begin()));
+        }
+        bool thrown = false;
+        try{
+            cb.at(cb.size());
+        }catch(const std::out_of_range&){
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    void test_copy_and_move(){
+        gl::pow2_circular_buffer<std::string> cb(4);
+        for(int i = 0; i < 6; ++i){
+            cb.push_back(std::string(20, char('a' + i)));
+        }
+        gl::pow2_circular_buffer<std::string> copy(cb);
+        assert(copy.size() == 4 && std::equal(copy.begin(), copy.end(), cb.begin()));
+        gl::pow2_circular_buffer<std::string> moved(std::move(copy));
+        assert(copy.capacity() == 0 && copy.empty());
+        assert(moved.front() == std::string(20, 'c') && moved.back() == std::string(20, 'f'));
+        copy = moved;
+        copy.erase_begin(2);
+        copy.erase_end(1);
+        assert(copy.size() == 1 && copy.front() == std::string(20, 'e'));
+        copy.clear();
+        assert(copy.empty() && moved.size() == 4);
+
+        std::vector<int> values = {1, 2, 3, 4, 5};
+        buffer_type from_range(values.begin(), values.end());
+        assert(from_range.capacity() == 8 && from_range.size() == 5);
+        buffer_type bounded(2, values.begin(), values.end());
+        assert(bounded.size() == 2 && bounded.front() == 4 && bounded.back() == 5);
+        buffer_type filled(3, 5, 7);
+        assert(filled.capacity() == 4 && filled.size() == 4 && filled.back() == 7);
+    }
+}
+
+int main(){
+    test_capacity();
+    test_overwrite();
+    test_copy_and_move();
+    std::puts("pow2_circular_buffer_test passed");
+    return 0;
+}
@@ -0,0 +1,107 @@
+//priority_sync_deque: strict priority order, the starvation quota rotation, per-lane capacity
+//and a producer against several consumers.
+//from the repository root: g++ -std=c++14 -pthread -I. test/priority_sync_deque_test.cpp && ./a.out
+#include "priority_sync_deque.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <cstddef>
+#include <array>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    typedef gl::priority_sync_deque<int, 3> queue_type;
+
+    static_assert(alignof(queue_type) <= alignof(std::max_align_t), "priority_sync_deque is over-aligned");
+
+    std::vector<std::size_t> pop_lanes(queue_type& q, std::size_t n){
+        std::vector<std::size_t> lanes;
+        int value;
+        std::size_t lane;
+        for(std::size_t i = 0; i < n; ++i){
+            assert(q.try_pop(value, lane));
+            assert(value / 100 == (int)lane);
+            lanes.push_back(lane);
+        }
+        return lanes;
+    }
+    void test_strict(){
+        queue_type q(8);
+        for(int i = 0; i < 3; ++i){
+            q.push_back(2, 200 + i);
+            q.push_back(1, 100 + i);
+            q.push_back(0, i);
+        }
+        assert(q.size() == 9 && q.size(1) == 3);
+        std::vector<std::size_t> expected = {0, 0, 0, 1, 1, 1, 2, 2, 2};
+        assert(pop_lanes(q, 9) == expected);
+        int value;
+        assert(q.empty() && !q.try_pop(value));
+    }
+    //with quota 2, two pops from the busy lane are followed by one from a waiting lane,
+    //the waiting lanes taken in turn
+    void test_starvation_quota(){
+        queue_type q(16, 2);
+        for(int i = 0; i < 10; ++i){
+            q.push_back(0, i);
+        }
+        for(int i = 0; i < 3; ++i){
+            q.push_back(1, 100 + i);
+            q.push_back(2, 200 + i);
+        }
+        std::vector<std::size_t> expected = {0, 0, 1, 0, 0, 2, 0, 0, 1, 0, 0, 2, 0, 0, 1, 2};
+        assert(pop_lanes(q, 16) == expected);
+    }
+    //a full low priority lane does not hold up the others
+    void test_lane_capacity(){
+        queue_type q(std::array<std::size_t, 3>{{4, 2, 1}});
+        assert(q.capacity(0) == 4 && q.capacity(1) == 2 && q.capacity(2) == 1);
+        assert(q.try_push(2, 200) && !q.try_push(2, 201));
+        assert(!q.push_for(2, std::chrono::milliseconds(1), 202));
+        assert(q.try_push(1, 100) && q.try_push(0, 0));
+        int value;
+        assert(q.pop_for(value, std::chrono::milliseconds(1)) && value == 0);
+        assert(q.pop_front() == 100);
+        //a blocked push to the full lane completes once that lane is popped
+        std::thread producer([&]{ q.push_back(2, 203); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        assert(q.pop_front() == 200);
+        producer.join();
+        assert(q.pop_front() == 203);
+        assert(!q.pop_until(value, std::chrono::steady_clock::now()));
+
+        bool thrown = false;
+        try{
+            q.push_back(3, 0);
+        }catch(const std::out_of_range&){
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    void test_strings(){
+        gl::priority_sync_deque<std::string, 2> q(2);
+        q.push_back(1, 20, 'b');
+        q.push_back(0, std::string(20, 'a'));
+        assert(q.pop_front() == std::string(20, 'a'));
+        assert(q.pop_front() == std::string(20, 'b'));
+        //elements still queued are destroyed with the queue
+        q.push_back(1, std::string(32, 'c'));
+    }
+    void test_threads(){
+        gl::priority_sync_deque<long, 3> q(16, 4);
+        gl_test::run_spmc(20000, 3, [&](long v){ q.push_back(v % 3, v); },
+                          [&](long& v){ return q.pop_for(v, std::chrono::milliseconds(1)); });
+    }
+}
+
+int main(){
+    test_strict();
+    test_starvation_quota();
+    test_lane_capacity();
+    test_strings();
+    test_threads();
+    std::puts("priority_sync_deque_test passed");
+    return 0;
+}
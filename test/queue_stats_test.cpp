@@ -0,0 +1,89 @@
+//sync_deque statistics: counters, depth and wait histograms.
+//from the repository root: g++ -std=c++14 -pthread -I. test/queue_stats_test.cpp && ./a.out
+#undef NDEBUG
+#include "sync_deque.h"
+#include <cassert>
+#include <cstdio>
+#include <cstddef>
+#include <chrono>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace {
+    typedef gl::sync_deque<int, true, std::allocator<int>, gl::locked_backend, gl::park_wait, true> queue_type;
+    typedef gl::sync_deque<int, true, std::allocator<int>, gl::mpmc_backend, gl::park_wait, true> mpmc_queue_type;
+
+    static_assert(alignof(queue_type) <= alignof(std::max_align_t), "sync_deque with stats is over-aligned");
+
+    std::uint64_t histogram_total(const gl::wait_stats& waits){
+        return std::accumulate(waits.histogram.begin(), waits.histogram.end(), std::uint64_t(0));
+    }
+    template<typename Queue>
+    void test_counters(){
+        Queue q(8);
+        for(int i = 0; i < 6; ++i){
+            q.push_back(i);
+        }
+        q.pop_front();
+        int out[8];
+        assert(q.pop_front_bulk(out, 2) == 2);
+        gl::queue_stats stats = q.stats();
+        assert(stats.pushed == 6 && stats.popped == 3);
+        assert(stats.depth == 3 && stats.max_depth == 6);
+        assert(stats.push_waits.count == 0 && stats.pop_waits.count == 0);
+
+        q.reset_stats();
+        stats = q.stats();
+        assert(stats.pushed == 0 && stats.popped == 0 && stats.max_depth == 0 && stats.depth == 3);
+    }
+    //only operations that had to wait are timed
+    void test_waits(){
+        queue_type q(1);
+        int value;
+        assert(!q.pop_for(value, std::chrono::milliseconds(2)));
+        gl::queue_stats stats = q.stats();
+        assert(stats.pop_waits.count == 1 && histogram_total(stats.pop_waits) == 1);
+        assert(stats.pop_waits.max_ns >= 2000000 && stats.pop_waits.total_ns >= stats.pop_waits.max_ns);
+
+        int out[4];
+        assert(q.pop_front_bulk(out, 4, 2, std::chrono::milliseconds(1)) == 0);
+        assert(q.stats().pop_waits.count == 2);
+
+        q.push_back(1);
+        std::thread consumer([&]{
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            q.pop_front();
+        });
+        q.push_back(2);
+        consumer.join();
+        stats = q.stats();
+        assert(stats.push_waits.count == 1 && histogram_total(stats.push_waits) == 1);
+        assert(stats.pushed == 2 && stats.popped == 1);
+    }
+    void test_elastic(){
+        gl::sync_deque<int, true, std::allocator<int>, gl::locked_backend, gl::park_wait, true>
+            q(gl::elastic_capacity(2, 16, std::chrono::milliseconds(1)));
+        for(int i = 0; i < 16; ++i){
+            q.push_back(i);
+        }
+        assert(q.stats().grows == 3);
+        for(int i = 0; i < 16; ++i){
+            q.pop_front();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        q.shrink_to_fit_if_idle();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        q.shrink_to_fit_if_idle();
+        assert(q.stats().shrinks >= 1);
+    }
+}
+
+int main(){
+    test_counters<queue_type>();
+    test_counters<mpmc_queue_type>();
+    test_waits();
+    test_elastic();
+    std::puts("queue_stats_test passed");
+    return 0;
+}
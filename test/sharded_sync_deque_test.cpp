@@ -0,0 +1,53 @@
+//sharded_sync_deque, and the cache line padding it shares with sync_deque.
+//from the repository root: g++ -std=c++14 -pthread -I. test/sharded_sync_deque_test.cpp && ./a.out
+#include "sharded_sync_deque.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <memory>
+
+namespace {
+    //padded, not over-aligned: plain new and make_shared are enough before C++17
+    static_assert(alignof(gl::sync_deque<int>) <= alignof(std::max_align_t), "sync_deque is over-aligned");
+    static_assert(alignof(gl::sharded_sync_deque<int>) <= alignof(std::max_align_t), "sharded_sync_deque is over-aligned");
+
+    void test_allocation(){
+        std::unique_ptr<gl::sync_deque<int>> q(new gl::sync_deque<int>(4));
+        assert(reinterpret_cast<std::uintptr_t>(q.get()) % alignof(gl::sync_deque<int>) == 0);
+        std::shared_ptr<gl::sync_deque<int>> shared = std::make_shared<gl::sync_deque<int>>(4);
+        shared->push_back(1);
+        assert(shared->pop_front() == 1);
+    }
+    void test_capacity(){
+        gl::sharded_sync_deque<int> q(10, 4);
+        assert(q.shard_count() == 4);
+        assert(q.capacity() == 12);
+        for(int i = 0; i < 12; ++i){
+            assert(q.try_push(i));
+        }
+        assert(!q.try_push(12));
+        assert(q.size() == 12);
+        int value;
+        long sum = 0;
+        while(q.try_pop(value)){
+            sum += value;
+        }
+        assert(sum == 66 && q.empty());
+        assert(!q.pop_for(value, std::chrono::milliseconds(1)));
+    }
+    void test_spmc(){
+        gl::sharded_sync_deque<long> q(64, 4);
+        gl_test::run_spmc(20000, 3, [&](long v){ q.push_back(v); },
+                          [&](long& v){ return q.pop_for(v, std::chrono::milliseconds(1)); });
+    }
+}
+
+int main(){
+    test_allocation();
+    test_capacity();
+    test_spmc();
+    std::puts("sharded_sync_deque_test passed");
+    return 0;
+}
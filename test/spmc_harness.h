@@ -0,0 +1,41 @@
+#ifndef TEST_SPMC_HARNESS_H_
+#define TEST_SPMC_HARNESS_H_
+
+#undef NDEBUG
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace gl_test {
+    //calls produce(v) for v = 1..items on this thread while consumers threads call try_consume(v)
+    //until all items are taken, then checks each was taken exactly once
+    template<typename Produce, typename TryConsume>
+    void run_spmc(long items, int consumers, Produce produce, TryConsume try_consume){
+        std::atomic<long> taken(0);
+        std::atomic<long> sum(0);
+        std::vector<std::thread> threads;
+        for(int i = 0; i < consumers; ++i){
+            threads.emplace_back([&]{
+                long value = 0;
+                while(taken.load() < items){
+                    if(try_consume(value)){
+                        sum += value;
+                        ++taken;
+                    }else{
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for(long i = 1; i <= items; ++i){
+            produce(i);
+        }
+        for(auto& t : threads){
+            t.join();
+        }
+        assert(taken.load() == items);
+        assert(sum.load() == items * (items + 1) / 2);
+    }
+}
+#endif
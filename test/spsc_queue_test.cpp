@@ -0,0 +1,61 @@
+//spsc_queue and blocking_spsc_queue: capacity, element lifetimes and one producer thread
+//against one consumer thread.
+//from the repository root: g++ -std=c++14 -pthread -I. test/spsc_queue_test.cpp && ./a.out
+#include "spsc_queue.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace {
+    static_assert(alignof(gl::spsc_queue<long>) <= alignof(std::max_align_t), "spsc_queue is over-aligned");
+
+    void test_fifo(){
+        gl::spsc_queue<std::string> q(3);
+        assert(q.capacity() == 3 && q.empty() && q.front() == nullptr && !q.pop());
+        //the indexes wrap around the capacity + 1 slots several times
+        for(int round = 0; round < 5; ++round){
+            for(int i = 0; i < 3; ++i){
+                assert(q.try_push(std::string(20, char('a' + i))));
+            }
+            assert(q.full() && q.size() == 3 && !q.try_emplace(1, 'x'));
+            std::string value;
+            assert(q.try_pop(value) && value == std::string(20, 'a'));
+            assert(*q.front() == std::string(20, 'b'));
+            assert(q.pop());
+            assert(q.try_emplace(2, 'd') && q.size() == 2);
+            assert(q.try_pop(value) && value == std::string(20, 'c'));
+            assert(q.try_pop(value) && value == "dd");
+            assert(q.empty() && !q.try_pop(value));
+        }
+        //elements still queued are destroyed with the queue
+        q.try_push(std::string(32, 'x'));
+    }
+    void test_blocking(){
+        gl::blocking_spsc_queue<std::string> q(2);
+        assert(q.try_push(std::string("a")) && q.try_emplace(1, 'b') && !q.try_push(std::string("c")));
+        assert(q.size() == 2 && q.capacity() == 2);
+        std::string value;
+        assert(q.try_pop(value) && value == "a");
+        assert(q.pop_front() == "b" && q.empty());
+    }
+    void test_threads(){
+        gl::spsc_queue<long> q(64);
+        gl_test::run_spmc(20000, 1, [&](long v){ while(!q.try_push(v)){ std::this_thread::yield(); } },
+                          [&](long& v){ return q.try_pop(v); });
+        //a small queue makes both sides park
+        gl::blocking_spsc_queue<long> b(2);
+        gl_test::run_spmc(20000, 1, [&](long v){ b.push_back(v); }, [&](long& v){ v = b.pop_front(); return true; });
+        gl::blocking_spsc_queue<long, std::allocator<long>, gl::park_wait> parked(2);
+        gl_test::run_spmc(20000, 1, [&](long v){ parked.push_back(v); }, [&](long& v){ v = parked.pop_front(); return true; });
+    }
+}
+
+int main(){
+    test_fifo();
+    test_blocking();
+    test_threads();
+    std::puts("spsc_queue_test passed");
+    return 0;
+}
@@ -0,0 +1,132 @@
+//static_circular_buffer: inline storage, overwrite at both ends, element lifetimes and
+//constant expression use for trivial element types.
+//from the repository root: g++ -std=c++14 -I. test/static_circular_buffer_test.cpp && ./a.out
+#undef NDEBUG
+#include "static_circular_buffer.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    static_assert(std::is_trivially_copyable<gl::static_circular_buffer<int, 4>>::value,
+                  "static_circular_buffer of a trivial type is trivially copyable");
+    static_assert(sizeof(gl::static_circular_buffer<int, 4>) == 4 * sizeof(int) + 2 * sizeof(std::size_t),
+                  "static_circular_buffer keeps its elements inline");
+    static_assert(gl::static_circular_buffer<int, 4>::capacity() == 4, "capacity is N");
+
+#if __cplusplus >= 201402L
+    constexpr int sum_of_last_three(){
+        gl::static_circular_buffer<int, 3> cb;
+        for(int i = 1; i <= 5; ++i){
+            cb.push_back(i);
+        }
+        int sum = 0;
+        for(int v : cb){
+            sum += v;
+        }
+        return sum;
+    }
+    static_assert(sum_of_last_three() == 3 + 4 + 5, "static_circular_buffer is usable in constant expressions");
+#endif
+
+    //counts live instances to check every constructed element is destroyed exactly once
+    struct counted {
+        static int live;
+        std::string value;
+
+        counted(int i) :value(20, char('a' + i % 26)) {
+            ++live;
+        }
+        counted(const counted& other) :value(other.value) {
+            ++live;
+        }
+        counted(counted&& other) :value(std::move(other.value)) {
+            ++live;
+        }
+        counted& operator=(const counted&) = default;
+        counted& operator=(counted&&) = default;
+        ~counted() {
+            --live;
+        }
+        bool operator==(const counted& other) const {
+            return value == other.value;
+        }
+    };
+    int counted::live = 0;
+
+    template<typename T>
+    void test_model(){
+        gl::static_circular_buffer<T, 5> cb;
+        std::deque<T> model;
+        for(int i = 0; i < 200; ++i){
+            switch(i % 9){
+            case 2:
+                cb.emplace_front(i);
+                if(model.size() == cb.capacity()){
+                    model.pop_back();
+                }
+                model.emplace_front(i);
+                break;
+            case 5:
+                if(!model.empty()){
+                    cb.pop_back();
+                    model.pop_back();
+                }
+                break;
+            case 7:
+                if(model.size() >= 2){
+                    cb.erase_begin(2);
+                    model.erase(model.begin(), model.begin() + 2);
+                }
+                break;
+            default:
+                cb.emplace_back(i);
+                if(model.size() == cb.capacity()){
+                    model.pop_front();
+                }
+                model.emplace_back(i);
+                break;
+            }
+            assert(cb.size() == model.size() && cb.reserve() == 5 - model.size());
+            assert(std::equal(cb.begin(), cb.end(), model.begin()));
+            assert(std::equal(cb.rbegin(), cb.rend(), model.rbegin()));
+            assert(cb.array_one().second + cb.array_two().second == cb.size());
+            std::vector<T> segments(cb.array_one().first, cb.array_one().first + cb.array_one().second);
+            segments.insert(segments.end(), cb.array_two().first, cb.array_two().first + cb.array_two().second);
+            assert(std::equal(segments.begin(), segments.end(), model.begin()));
+        }
+        gl::static_circular_buffer<T, 5> copy(cb);
+        assert(std::equal(copy.begin(), copy.end(), model.begin()));
+        gl::static_circular_buffer<T, 5> moved(std::move(copy));
+        assert(std::equal(moved.begin(), moved.end(), model.begin()));
+        copy = moved;
+        copy.erase_end(1);
+        assert(copy.size() == model.size() - 1);
+        moved = std::move(copy);
+        assert(moved.size() == model.size() - 1);
+        moved.clear();
+        assert(moved.empty());
+    }
+}
+
+int main(){
+    test_model<int>();
+    test_model<counted>();
+    assert(counted::live == 0);
+
+    gl::static_circular_buffer<counted, 3> filled(5, counted(1));
+    assert(filled.full() && filled.front() == counted(1));
+    bool thrown = false;
+    try{
+        filled.at(3);
+    }catch(const std::out_of_range&){
+        thrown = true;
+    }
+    assert(thrown);
+    std::puts("static_circular_buffer_test passed");
+    return 0;
+}
@@ -0,0 +1,117 @@
+//sync_deque push_back_bulk/pop_front_bulk: chunking around a full queue, batch waits and
+//concurrent consumers, for the locked and mpmc backends.
+//from the repository root: g++ -std=c++14 -pthread -I. test/sync_deque_bulk_test.cpp && ./a.out
+#include "sync_deque.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <chrono>
+#include <list>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+    template<typename Queue>
+    void test_single_thread(){
+        Queue q(8);
+        std::vector<long> values(6);
+        std::iota(values.begin(), values.end(), 1);
+        q.push_back_bulk(values.begin(), values.end());
+        assert(q.size() == 6);
+        long out[8];
+        assert(q.pop_front_bulk(out, 0) == 0);
+        assert(q.pop_front_bulk(out, 4) == 4);
+        assert(out[0] == 1 && out[3] == 4);
+        assert(q.pop_front_bulk(out, 8) == 2);
+        assert(out[0] == 5 && out[1] == 6 && q.empty());
+
+        //min_n is not reached before the timeout: whatever is there is taken
+        q.push_back(7);
+        assert(q.pop_front_bulk(out, 8, 4, std::chrono::milliseconds(1)) == 1 && out[0] == 7);
+        assert(q.pop_front_bulk(out, 8, 4, std::chrono::milliseconds(1)) == 0);
+        //min_n above the capacity is lowered to it
+        q.push_back_bulk(values.begin(), values.end());
+        q.push_back_bulk(values.begin(), values.begin() + 2);
+        assert(q.pop_front_bulk(out, 16, 16, std::chrono::seconds(10)) == 8);
+    }
+    //a range longer than the capacity is pushed in chunks as consumers make room
+    template<typename Queue>
+    void test_chunks(){
+        Queue q(4);
+        std::list<std::string> values;
+        for(int i = 0; i < 50; ++i){
+            values.push_back(std::string(20, char('a' + i % 26)));
+        }
+        std::vector<std::string> taken;
+        std::thread consumer([&]{
+            std::string out[3];
+            while(taken.size() < values.size()){
+                std::size_t n = q.pop_front_bulk(out, 3);
+                assert(n >= 1 && n <= 3);
+                taken.insert(taken.end(), out, out + n);
+            }
+        });
+        q.push_back_bulk(values.begin(), values.end());
+        consumer.join();
+        assert(std::equal(taken.begin(), taken.end(), values.begin()));
+    }
+    //a consumer waiting for a batch is woken once min_n elements are there
+    void test_batch_wakeup(){
+        gl::sync_deque<long> q(16);
+        std::thread consumer([&]{
+            long out[16];
+            std::size_t n = q.pop_front_bulk(out, 16, 5, std::chrono::seconds(10));
+            assert(n >= 5);
+            for(std::size_t i = 0; i < n; ++i){
+                assert(out[i] == long(i));
+            }
+        });
+        for(long i = 0; i < 5; ++i){
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            q.push_back(i);
+        }
+        consumer.join();
+    }
+    template<typename Queue>
+    void test_threads(){
+        const long items = 20000;
+        Queue q(64);
+        std::vector<long> values(items);
+        std::iota(values.begin(), values.end(), 1);
+        std::atomic<long> taken(0);
+        std::atomic<long> sum(0);
+        std::vector<std::thread> threads;
+        for(int i = 0; i < 3; ++i){
+            threads.emplace_back([&]{
+                long batch[16];
+                while(taken.load() < items){
+                    long n = q.pop_front_bulk(batch, 16, 4, std::chrono::milliseconds(1));
+                    for(long j = 0; j < n; ++j){
+                        sum += batch[j];
+                    }
+                    taken += n;
+                }
+            });
+        }
+        q.push_back_bulk(values.begin(), values.end());
+        for(auto& t : threads){
+            t.join();
+        }
+        assert(taken.load() == items);
+        assert(sum.load() == items * (items + 1) / 2);
+    }
+}
+
+int main(){
+    typedef gl::sync_deque<long> locked_type;
+    typedef gl::sync_deque<long, true, std::allocator<long>, gl::mpmc_backend> mpmc_type;
+    test_single_thread<locked_type>();
+    test_single_thread<mpmc_type>();
+    test_chunks<gl::sync_deque<std::string>>();
+    test_chunks<gl::sync_deque<std::string, true, std::allocator<std::string>, gl::mpmc_backend>>();
+    test_batch_wakeup();
+    test_threads<locked_type>();
+    test_threads<mpmc_type>();
+    std::puts("sync_deque_bulk_test passed");
+    return 0;
+}
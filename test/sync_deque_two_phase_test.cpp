@@ -0,0 +1,117 @@
+//sync_deque two-phase claim/publish/cancel and borrow/release on the mpmc backend: order across
+//out of order publishes, cancelled cells, blocking claims and concurrent consumers.
+//from the repository root: g++ -std=c++14 -pthread -I. test/sync_deque_two_phase_test.cpp && ./a.out
+#include "sync_deque.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <chrono>
+#include <new>
+#include <string>
+
+namespace {
+    typedef gl::sync_deque<std::string, true, std::allocator<std::string>, gl::mpmc_backend> queue_type;
+
+    std::string take(queue_type& q){
+        std::string* p = q.try_borrow_front();
+        assert(p != nullptr);
+        std::string value = *p;
+        q.release_front(p);
+        return value;
+    }
+    //consumers see elements in claim order, and stop at a claimed cell until it is published
+    void test_claim_order(){
+        queue_type q(4);
+        std::string* a = q.claim_back();
+        std::string* b = q.try_claim_back();
+        assert(a != nullptr && b != nullptr && a != b);
+        new(b) std::string(20, 'b');
+        q.publish_back(b);
+        assert(q.try_borrow_front() == nullptr);
+        new(a) std::string(20, 'a');
+        q.publish_back(a);
+        assert(take(q) == std::string(20, 'a'));
+        assert(take(q) == std::string(20, 'b'));
+        assert(q.try_borrow_front() == nullptr && q.empty());
+
+        //borrow_front leaves the element in place until it is released
+        q.push_back(std::string(32, 'c'));
+        std::string* p = q.borrow_front();
+        assert(*p == std::string(32, 'c'));
+        q.release_front(p);
+        assert(q.empty());
+    }
+    //cancelled claims are skipped by consumers and their cells reused by producers
+    void test_cancel(){
+        queue_type q(2);
+        std::string* a = q.claim_back();
+        std::string* b = q.claim_back();
+        assert(q.try_claim_back() == nullptr);
+        q.cancel_back(a);
+        new(b) std::string("b");
+        q.publish_back(b);
+        assert(take(q) == "b");
+        assert(q.try_borrow_front() == nullptr);
+
+        //a full queue whose oldest cell is a cancelled claim still takes a push
+        a = q.claim_back();
+        b = q.claim_back();
+        q.cancel_back(a);
+        std::string* c = q.try_claim_back();
+        assert(c != nullptr);
+        new(b) std::string("b");
+        q.publish_back(b);
+        new(c) std::string("c");
+        q.publish_back(c);
+        assert(take(q) == "b" && take(q) == "c" && q.empty());
+    }
+    //a blocked claim completes once a borrowed element is released
+    void test_blocking_claim(){
+        queue_type q(2);
+        q.push_back(std::string("a"));
+        q.push_back(std::string("b"));
+        std::thread producer([&]{
+            std::string* p = q.claim_back();
+            new(p) std::string("c");
+            q.publish_back(p);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::string* p = q.borrow_front();
+        assert(*p == "a");
+        q.release_front(p);
+        producer.join();
+        assert(take(q) == "b" && take(q) == "c");
+        std::string value;
+        assert(!q.pop_for(value, std::chrono::milliseconds(1)));
+    }
+    //every other claim is cancelled before being published again, consumers borrow in place
+    void test_threads(){
+        gl::sync_deque<long, true, std::allocator<long>, gl::mpmc_backend> q(64);
+        gl_test::run_spmc(20000, 3,
+            [&](long v){
+                if(v % 2 == 0){
+                    q.cancel_back(q.claim_back());
+                }
+                long* p = q.claim_back();
+                new(p) long(v);
+                q.publish_back(p);
+            },
+            [&](long& v){
+                long* p = q.try_borrow_front();
+                if(p == nullptr){
+                    return false;
+                }
+                v = *p;
+                q.release_front(p);
+                return true;
+            });
+    }
+}
+
+int main(){
+    test_claim_order();
+    test_cancel();
+    test_blocking_claim();
+    test_threads();
+    std::puts("sync_deque_two_phase_test passed");
+    return 0;
+}
@@ -0,0 +1,130 @@
+//thread_pool: submit from outside and inside workers, submit_bulk past the injection
+//capacity, parallel_for (nested, with exceptions) and running every task before destruction.
+//from the repository root: g++ -std=c++14 -pthread -I. test/thread_pool_test.cpp && ./a.out
+#undef NDEBUG
+#include "thread_pool.h"
+#include <cassert>
+#include <cstdio>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    const long items = 20000;
+    const long expected_sum = items * (items + 1) / 2;
+
+    void test_submit(){
+        std::atomic<long> sum(0);
+        {
+            gl::thread_pool pool(3);
+            assert(pool.size() == 3);
+            for(long i = 1; i <= items / 2; ++i){
+                pool.submit([&sum, i]{ sum += i; });
+            }
+            std::vector<std::function<void()>> tasks;
+            for(long i = items / 2 + 1; i <= items; ++i){
+                tasks.push_back([&sum, i]{ sum += i; });
+            }
+            pool.submit_bulk(tasks.begin(), tasks.end());
+        }
+        assert(sum.load() == expected_sum);
+    }
+    //tasks submitted by a task go to the worker's own deque and are stolen by the others
+    void test_submit_from_worker(){
+        std::atomic<long> sum(0);
+        {
+            gl::thread_pool pool(3);
+            for(long i = 0; i < 100; ++i){
+                pool.submit([&pool, &sum, i]{
+                    std::vector<std::function<void()>> tasks;
+                    for(long j = 1; j <= items / 100; ++j){
+                        long value = i * (items / 100) + j;
+                        if(j % 2 == 0){
+                            pool.submit([&sum, value]{ sum += value; });
+                        }else{
+                            tasks.push_back([&sum, value]{ sum += value; });
+                        }
+                    }
+                    pool.submit_bulk(tasks.begin(), tasks.end());
+                });
+            }
+        }
+        assert(sum.load() == expected_sum);
+    }
+    //a range longer than the injection queue goes in chunks, the workers draining each
+    void test_submit_bulk_past_capacity(){
+        std::atomic<long> sum(0);
+        {
+            gl::thread_pool pool(2, false, 8);
+            std::vector<std::function<void()>> tasks;
+            for(long i = 1; i <= 1000; ++i){
+                tasks.push_back([&sum, i]{ sum += i; });
+            }
+            pool.submit_bulk(tasks.begin(), tasks.end());
+        }
+        assert(sum.load() == 1000 * 1001 / 2);
+    }
+    void test_parallel_for(){
+        gl::thread_pool pool(3, true);
+        std::vector<std::atomic<int>> hits(10007);
+        for(auto& hit : hits){
+            hit = 0;
+        }
+        pool.parallel_for(std::size_t(0), hits.size(), [&](std::size_t i){ ++hits[i]; });
+        for(auto& hit : hits){
+            assert(hit.load() == 1);
+        }
+        pool.parallel_for(5, 5, [](int){ assert(false); });
+
+        //nested: the outer chunks wait by running the inner ones
+        std::atomic<long> sum(0);
+        pool.parallel_for(0L, 100L, [&](long i){
+            pool.parallel_for(0L, 100L, [&, i](long j){ sum += i * 100 + j; }, 7L);
+        }, 3L);
+        assert(sum.load() == 9999L * 10000 / 2);
+
+        bool thrown = false;
+        try{
+            pool.parallel_for(0, 1000, [](int i){
+                if(i == 500){
+                    throw std::runtime_error("500");
+                }
+            });
+        }catch(const std::runtime_error& e){
+            thrown = std::string(e.what()) == "500";
+        }
+        assert(thrown);
+    }
+    void test_run_one(){
+        gl::thread_pool pool(1);
+        std::atomic<bool> busy(false);
+        std::atomic<bool> release(false);
+        std::atomic<int> done(0);
+        //keep the only worker busy so the calling thread has to run the next task
+        pool.submit([&]{
+            busy = true;
+            while(!release.load()){
+                std::this_thread::yield();
+            }
+        });
+        while(!busy.load()){
+            std::this_thread::yield();
+        }
+        pool.submit([&]{ ++done; });
+        assert(pool.run_one() && done.load() == 1);
+        assert(!pool.run_one());
+        release = true;
+    }
+}
+
+int main(){
+    test_submit();
+    test_submit_from_worker();
+    test_submit_bulk_past_capacity();
+    test_parallel_for();
+    test_run_one();
+    std::puts("thread_pool_test passed");
+    return 0;
+}
@@ -0,0 +1,97 @@
+//sync_deque try/timed operations under every WaitStrategy, and the strategies on their own.
+//from the repository root: g++ -std=c++14 -pthread -I. test/wait_strategy_test.cpp && ./a.out
+#include "sync_deque.h"
+#include "wait_strategy.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <chrono>
+#include <string>
+
+namespace {
+    template<typename WaitStrategy>
+    void test_try_and_timed(){
+        typedef gl::sync_deque<std::string, true, std::allocator<std::string>, gl::locked_backend, WaitStrategy> queue_type;
+        queue_type q(2);
+        std::string value = "untouched";
+        assert(!q.try_pop(value) && value == "untouched");
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        assert(!q.pop_for(value, std::chrono::milliseconds(2)) && value == "untouched");
+        assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(2));
+        assert(!q.pop_until(value, std::chrono::steady_clock::now() - std::chrono::seconds(1)));
+
+        assert(q.try_push(std::string("a")));
+        assert(q.push_for(std::chrono::milliseconds(1), 1, 'b'));
+        assert(!q.try_push(std::string("c")));
+        start = std::chrono::steady_clock::now();
+        assert(!q.push_for(std::chrono::milliseconds(2), std::string("c")));
+        assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(2));
+        assert(q.size() == 2);
+
+        assert(q.pop_until(value, std::chrono::steady_clock::now()) && value == "a");
+        assert(q.try_pop(value) && value == "b" && q.empty());
+
+        //a blocked timed push completes once a consumer makes room
+        q.push_back(std::string("d"));
+        q.push_back(std::string("e"));
+        std::thread consumer([&]{
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            assert(q.pop_front() == "d");
+        });
+        assert(q.push_for(std::chrono::seconds(10), std::string("f")));
+        consumer.join();
+        assert(q.pop_back() == "f" && q.pop_front() == "e");
+    }
+    //few items: spinning consumers starve the producer on a single core
+    template<typename WaitStrategy>
+    void test_threads(){
+        typedef gl::sync_deque<long, true, std::allocator<long>, gl::locked_backend, WaitStrategy> locked_type;
+        typedef gl::sync_deque<long, true, std::allocator<long>, gl::mpmc_backend, WaitStrategy> mpmc_type;
+        locked_type locked(8);
+        gl_test::run_spmc(2000, 3, [&](long v){ locked.push_back(v); },
+                          [&](long& v){ return locked.pop_for(v, std::chrono::milliseconds(1)); });
+        mpmc_type lock_free(8);
+        gl_test::run_spmc(2000, 3, [&](long v){ while(!lock_free.push_for(std::chrono::milliseconds(1), v)){} },
+                          [&](long& v){ return lock_free.try_pop(v); });
+    }
+    //notify_n wakes up to n of the sleeping waiters
+    void test_notify_n(){
+        gl::park_wait wait;
+        std::atomic<int> tickets(0);
+        std::atomic<int> woken(0);
+        std::vector<std::thread> threads;
+        for(int i = 0; i < 4; ++i){
+            threads.emplace_back([&]{
+                wait.wait([&]()->bool{
+                    int n = tickets.load();
+                    return n > 0 && tickets.compare_exchange_strong(n, n - 1);
+                });
+                ++woken;
+            });
+        }
+        tickets += 2;
+        wait.notify_n(2);
+        while(woken.load() < 2){
+            std::this_thread::yield();
+        }
+        tickets += 2;
+        wait.notify_n(8);
+        for(auto& t : threads){
+            t.join();
+        }
+        assert(woken.load() == 4 && tickets.load() == 0);
+    }
+}
+
+int main(){
+    test_try_and_timed<gl::busy_spin_wait>();
+    test_try_and_timed<gl::spin_yield_wait<>>();
+    test_try_and_timed<gl::spin_park_wait<>>();
+    test_try_and_timed<gl::park_wait>();
+    test_threads<gl::busy_spin_wait>();
+    test_threads<gl::spin_yield_wait<>>();
+    test_threads<gl::spin_park_wait<>>();
+    test_threads<gl::park_wait>();
+    test_notify_n();
+    std::puts("wait_strategy_test passed");
+    return 0;
+}
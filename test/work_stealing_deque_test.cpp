@@ -0,0 +1,88 @@
+//work_stealing_deque: owner LIFO and thief FIFO order, growth, and an owner popping while
+//thieves steal, each element taken exactly once.
+//from the repository root: g++ -std=c++14 -pthread -I. test/work_stealing_deque_test.cpp && ./a.out
+#include "work_stealing_deque.h"
+#include "spmc_harness.h"
+#include <cstdio>
+#include <cstddef>
+
+namespace {
+    static_assert(alignof(gl::work_stealing_deque<long>) <= alignof(std::max_align_t), "work_stealing_deque is over-aligned");
+
+    void test_order_and_growth(){
+        gl::work_stealing_deque<long> q(3);
+        assert(q.capacity() == 4 && q.empty());
+        long value;
+        assert(!q.try_pop_back(value) && !q.try_steal(value));
+        for(long i = 0; i < 10; ++i){
+            q.push_back(i);
+        }
+        assert(q.size() == 10 && q.capacity() == 16);
+        assert(q.try_steal(value) && value == 0);
+        assert(q.try_pop_back(value) && value == 9);
+        assert(q.try_steal(value) && value == 1);
+        assert(q.try_pop_back(value) && value == 8);
+        for(long i = 2; i < 8; ++i){
+            assert(q.try_steal(value) && value == i);
+        }
+        assert(q.empty() && !q.try_pop_back(value) && !q.try_steal(value));
+        //the indexes keep running after the deque emptied
+        q.push_back(42);
+        assert(q.try_pop_back(value) && value == 42 && q.empty());
+    }
+    //the owner pushes, and from time to time pops its newest element and pushes it again,
+    //while thieves steal; the ring starts small so it grows under them
+    void test_owner_and_thieves(){
+        gl::work_stealing_deque<long> q(2);
+        gl_test::run_spmc(20000, 3,
+            [&](long v){
+                q.push_back(v);
+                long back;
+                if(v % 3 == 0 && q.try_pop_back(back)){
+                    q.push_back(back);
+                }
+            },
+            [&](long& v){ return q.try_steal(v); });
+    }
+    //the owner and the thieves race for the elements, the owner taking from the back
+    void test_pop_against_steal(){
+        const long items = 20000;
+        gl::work_stealing_deque<long> q(16);
+        for(long i = 1; i <= items; ++i){
+            q.push_back(i);
+        }
+        std::atomic<long> taken(0);
+        std::atomic<long> sum(0);
+        std::vector<std::thread> thieves;
+        for(int i = 0; i < 3; ++i){
+            thieves.emplace_back([&]{
+                long value;
+                while(taken.load() < items){
+                    if(q.try_steal(value)){
+                        sum += value;
+                        ++taken;
+                    }
+                }
+            });
+        }
+        long value;
+        while(taken.load() < items){
+            if(q.try_pop_back(value)){
+                sum += value;
+                ++taken;
+            }
+        }
+        for(auto& t : thieves){
+            t.join();
+        }
+        assert(taken.load() == items && sum.load() == items * (items + 1) / 2);
+    }
+}
+
+int main(){
+    test_order_and_growth();
+    test_owner_and_thieves();
+    test_pop_against_steal();
+    std::puts("work_stealing_deque_test passed");
+    return 0;
+}
@@ -0,0 +1,253 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include "cache_line.h"
+#include "sync_deque.h"
+#include "work_stealing_deque.h"
+#include "wait_strategy.h"
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <exception>
+#include <algorithm>
+#include <cstdint>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace gl {
+    class thread_pool;
+
+    //over-aligned, allocate with _make_aligned_unique
+    struct alignas(cache_line_size) _thread_pool_worker {
+        _thread_pool_worker(thread_pool* pool_, std::size_t index_)
+            : pool(pool_),index(index_),seed(index_ * 2654435761u + 1) {
+        }
+        thread_pool*                                    pool;
+        std::size_t                                     index;
+        std::uint32_t                                   seed;
+        work_stealing_deque<std::function<void()>*>     tasks;
+        std::thread                                     thread;
+    };
+
+    //work-stealing executor. tasks submitted from a worker go to that worker's own deque,
+    //tasks from other threads to a shared injection queue. an idle worker takes from its own deque,
+    //then the injection queue, then steals from the other workers before it sleeps.
+    //the destructor runs every task already submitted before joining the workers
+    class thread_pool {
+    public:
+        typedef std::size_t             size_type;
+        typedef std::function<void()>   task_type;
+    private:
+        typedef sync_deque<task_type*, true, std::allocator<task_type*>, mpmc_backend, spin_park_wait<>> injection_queue_type;
+    public:
+        //pin_threads binds worker i to cpu i modulo the number of cpus (Linux only)
+        explicit thread_pool(size_type threads = std::thread::hardware_concurrency(), bool pin_threads = false,
+                             size_type injection_capacity = 4096)
+            : d_injection(injection_capacity),d_stop(false) {
+            threads = std::max<size_type>(threads, 1);
+            for(size_type i = 0; i < threads; ++i){
+                d_workers.push_back(_make_aligned_unique<_thread_pool_worker>(this, i));
+            }
+            try{
+                for(size_type i = 0; i < threads; ++i){
+                    _thread_pool_worker* worker = d_workers[i].get();
+                    worker->thread = std::thread([this,worker]{ run(worker); });
+                    if(pin_threads){
+                        pin(worker->thread, i);
+                    }
+                }
+            }catch(...){
+                //workers already started would still be joinable when destroyed
+                stop();
+                throw;
+            }
+        }
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        ~thread_pool() {
+            stop();
+        }
+        size_type size() const {
+            return d_workers.size();
+        }
+
+        template<typename Function>
+        void submit(Function&& f){
+            task_type* task = new task_type(std::forward<Function>(f));
+            _thread_pool_worker* worker = current_worker();
+            if(worker != nullptr && worker->pool == this){
+                worker->tasks.push_back(task);
+            }else{
+                d_injection.push_back(task);
+            }
+            d_idle.notify_one();
+        }
+        //submits a range of callables waking the workers once
+        template<typename InputIterator>
+        void submit_bulk(InputIterator first, InputIterator last){
+            std::vector<task_type*> tasks;
+            for(; first != last; ++first){
+                tasks.push_back(new task_type(*first));
+            }
+            _thread_pool_worker* worker = current_worker();
+            if(worker != nullptr && worker->pool == this){
+                for(task_type* task : tasks){
+                    worker->tasks.push_back(task);
+                }
+                d_idle.notify_n(tasks.size());
+                return;
+            }
+            //a push waiting for room needs workers woken for what is already queued,
+            //so larger ranges go in chunks of the injection capacity
+            size_type chunk = d_injection.capacity();
+            for(size_type i = 0; i < tasks.size(); i += chunk){
+                size_type n = std::min(chunk, tasks.size() - i);
+                d_injection.push_back_bulk(tasks.begin() + i, tasks.begin() + i + n);
+                d_idle.notify_n(n);
+            }
+        }
+        //calls f(i) for every i in [first,last) in chunks of grain indexes (by default about
+        //four chunks per worker) and returns when all are done. the calling thread runs tasks
+        //while it waits, so parallel_for can be nested inside pool tasks. the first exception
+        //thrown by f is rethrown here
+        template<typename Index, typename Function>
+        void parallel_for(Index first, Index last, Function f, Index grain = 0){
+            if(!(first < last)){
+                return;
+            }
+            Index n = last - first;
+            if(!(Index(0) < grain)){
+                grain = std::max<Index>(1, (n + Index(4 * size()) - 1) / Index(4 * size()));
+            }
+            std::atomic<size_type> remaining((n + grain - 1) / grain);
+            std::exception_ptr error;
+            std::atomic<bool> failed(false);
+            std::vector<task_type> chunks;
+            chunks.reserve(remaining.load(std::memory_order_relaxed));
+            for(Index begin = first; begin < last; begin = (last - begin > grain ? begin + grain : last)){
+                Index end = last - begin > grain ? begin + grain : last;
+                chunks.emplace_back([&f,&remaining,&error,&failed,begin,end]{
+                    try{
+                        for(Index i = begin; i < end; ++i){
+                            f(i);
+                        }
+                    }catch(...){
+                        if(!failed.exchange(true)){
+                            error = std::current_exception();
+                        }
+                    }
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+                });
+            }
+            submit_bulk(chunks.begin(), chunks.end());
+            while(remaining.load(std::memory_order_acquire) != 0){
+                if(!run_one()){
+                    std::this_thread::yield();
+                }
+            }
+            if(error){
+                std::rethrow_exception(error);
+            }
+        }
+        //runs one pending task on the calling thread, returns false if none was found
+        bool run_one(){
+            _thread_pool_worker* worker = current_worker();
+            task_type* task = take(worker != nullptr && worker->pool == this ? worker : nullptr);
+            if(task == nullptr){
+                return false;
+            }
+            execute(task);
+            return true;
+        }
+    private:
+        static _thread_pool_worker*& current_worker(){
+            static thread_local _thread_pool_worker* worker = nullptr;
+            return worker;
+        }
+        void stop(){
+            d_stop.store(true, std::memory_order_release);
+            d_idle.notify_all();
+            for(auto& worker : d_workers){
+                if(worker->thread.joinable()){
+                    worker->thread.join();
+                }
+            }
+        }
+        static void pin(std::thread& thread, size_type index){
+#if defined(__linux__)
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(index % std::max(1u, std::thread::hardware_concurrency()), &cpus);
+            pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+#else
+            (void)thread;
+            (void)index;
+#endif
+        }
+        static void execute(task_type* task){
+            std::unique_ptr<task_type> owner(task);
+            (*owner)();
+        }
+        void run(_thread_pool_worker* worker){
+            current_worker() = worker;
+            for(;;){
+                task_type* task = take(worker);
+                if(task != nullptr){
+                    execute(task);
+                    continue;
+                }
+                if(d_stop.load(std::memory_order_acquire)){
+                    break;
+                }
+                d_idle.wait([this]()->bool{ return d_stop.load(std::memory_order_acquire) || has_work(); });
+            }
+            current_worker() = nullptr;
+        }
+        //own deque first, then the injection queue, then a steal sweep starting at a random victim
+        task_type* take(_thread_pool_worker* worker){
+            task_type* task = nullptr;
+            if(worker != nullptr && worker->tasks.try_pop_back(task)){
+                return task;
+            }
+            if(d_injection.try_pop(task)){
+                return task;
+            }
+            size_type n = d_workers.size();
+            size_type start = 0;
+            if(worker != nullptr){
+                worker->seed ^= worker->seed << 13;
+                worker->seed ^= worker->seed >> 17;
+                worker->seed ^= worker->seed << 5;
+                start = worker->seed % n;
+            }
+            for(size_type i = 0; i < n; ++i){
+                _thread_pool_worker* victim = d_workers[(start + i) % n].get();
+                if(victim != worker && victim->tasks.try_steal(task)){
+                    return task;
+                }
+            }
+            return nullptr;
+        }
+        bool has_work() const {
+            if(!d_injection.empty()){
+                return true;
+            }
+            for(auto& worker : d_workers){
+                if(!worker->tasks.empty()){
+                    return true;
+                }
+            }
+            return false;
+        }
+    private:
+        std::vector<_aligned_unique_ptr<_thread_pool_worker>>   d_workers;
+        injection_queue_type                                    d_injection;
+        spin_park_wait<>                                        d_idle;
+        std::atomic<bool>                                       d_stop;
+    };
+}
+#endif
@@ -0,0 +1,178 @@
+#ifndef WAIT_STRATEGY_H_
+#define WAIT_STRATEGY_H_
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+
+namespace gl {
+    //tells the core another thread is spinning, without giving up the time slice
+    inline void cpu_relax(){
+#if defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        asm volatile("yield");
+#endif
+    }
+
+    //wait strategies let a queue choose how a thread waits for a condition it polls, ready(),
+    //to become true. wait() returns once ready() returned true, wait_until() returns ready() as of
+    //the deadline if it expires first. a queue calls notify_one()/notify_all() after every change
+    //that can make a waiter's ready() true, notify_n(n) after a change that can satisfy up to n
+    //waiters; only strategies that sleep need them.
+
+    //polls without ever leaving the cpu: the lowest latency, but burns a core per waiter
+    class busy_spin_wait {
+    public:
+        template<typename Predicate>
+        void wait(Predicate ready){
+            while(!ready()){
+                cpu_relax();
+            }
+        }
+        template<typename Predicate, typename Clock, typename Duration>
+        bool wait_until(Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline){
+            for(unsigned i = 0; ; ++i){
+                if(ready()){
+                    return true;
+                }
+                if(i % 64 == 63 && Clock::now() >= deadline){
+                    return ready();
+                }
+                cpu_relax();
+            }
+        }
+        void notify_one(){
+        }
+        void notify_all(){
+        }
+        void notify_n(std::size_t){
+        }
+    };
+
+    //spins Spins times, then keeps polling but yields the cpu between polls
+    template<unsigned Spins=128>
+    class spin_yield_wait {
+    public:
+        template<typename Predicate>
+        void wait(Predicate ready){
+            for(unsigned i = 0; !ready(); ++i){
+                pause(i);
+            }
+        }
+        template<typename Predicate, typename Clock, typename Duration>
+        bool wait_until(Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline){
+            for(unsigned i = 0; ; ++i){
+                if(ready()){
+                    return true;
+                }
+                if(i >= Spins && Clock::now() >= deadline){
+                    return ready();
+                }
+                pause(i);
+            }
+        }
+        void notify_one(){
+        }
+        void notify_all(){
+        }
+        void notify_n(std::size_t){
+        }
+    private:
+        static void pause(unsigned i){
+            if(i < Spins){
+                cpu_relax();
+            }else{
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    //spins Spins times, then sleeps on a futex-backed condition variable until notified.
+    //notify costs a fence and a relaxed load while nobody sleeps
+    template<unsigned Spins=128>
+    class spin_park_wait {
+    public:
+        spin_park_wait() : d_waiters(0) {
+        }
+        spin_park_wait(const spin_park_wait&) = delete;
+        spin_park_wait& operator=(const spin_park_wait&) = delete;
+        template<typename Predicate>
+        void wait(Predicate ready){
+            if(spin(ready)){
+                return;
+            }
+            std::unique_lock<std::mutex> lock(d_mutex);
+            d_waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            while(!ready()){
+                d_cond.wait(lock);
+            }
+            d_waiters.fetch_sub(1, std::memory_order_relaxed);
+        }
+        template<typename Predicate, typename Clock, typename Duration>
+        bool wait_until(Predicate ready, const std::chrono::time_point<Clock, Duration>& deadline){
+            if(spin(ready)){
+                return true;
+            }
+            std::unique_lock<std::mutex> lock(d_mutex);
+            d_waiters.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool result = d_cond.wait_until(lock, deadline, ready);
+            d_waiters.fetch_sub(1, std::memory_order_relaxed);
+            return result;
+        }
+        void notify_one(){
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(d_waiters.load(std::memory_order_relaxed) != 0){
+                std::lock_guard<std::mutex> lock(d_mutex);
+                d_cond.notify_one();
+            }
+        }
+        void notify_all(){
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(d_waiters.load(std::memory_order_relaxed) != 0){
+                std::lock_guard<std::mutex> lock(d_mutex);
+                d_cond.notify_all();
+            }
+        }
+        //wakes up to n sleeping waiters, all of them if no more than n sleep
+        void notify_n(std::size_t n){
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int waiters = d_waiters.load(std::memory_order_relaxed);
+            if(waiters == 0 || n == 0){
+                return;
+            }
+            std::lock_guard<std::mutex> lock(d_mutex);
+            if(n >= static_cast<std::size_t>(waiters)){
+                d_cond.notify_all();
+                return;
+            }
+            for(; n != 0; --n){
+                d_cond.notify_one();
+            }
+        }
+    private:
+        template<typename Predicate>
+        static bool spin(Predicate& ready){
+            for(unsigned i = 0; i < Spins; ++i){
+                if(ready()){
+                    return true;
+                }
+                cpu_relax();
+            }
+            return ready();
+        }
+    private:
+        std::atomic<int>        d_waiters;
+        std::mutex              d_mutex;
+        std::condition_variable d_cond;
+    };
+
+    //sleeps straight away, like waiting on a plain condition variable
+    typedef spin_park_wait<0> park_wait;
+}
+#endif
@@ -0,0 +1,166 @@
+#ifndef WORK_STEALING_DEQUE_H_
+#define WORK_STEALING_DEQUE_H_
+
+#include "cache_line.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+namespace gl {
+    //ring of atomic slots addressed like pow2_circular_buffer: free-running indexes masked by capacity-1
+    template<typename T, typename Alloc>
+    class _work_stealing_array {
+    public:
+        typedef typename std::allocator_traits<Alloc>::template rebind_alloc<std::atomic<T>>    slot_allocator_type;
+        typedef std::allocator_traits<slot_allocator_type>                                      slot_alloc_traits;
+    public:
+        _work_stealing_array(std::size_t capacity, const Alloc & alloc)
+            : d_mask(capacity - 1),d_alloc(alloc) {
+            d_slots = slot_alloc_traits::allocate(d_alloc, capacity);
+            for(std::size_t i = 0; i < capacity; ++i){
+                ::new(static_cast<void*>(d_slots + i)) std::atomic<T>();
+            }
+        }
+        _work_stealing_array(const _work_stealing_array&) = delete;
+        _work_stealing_array& operator=(const _work_stealing_array&) = delete;
+        ~_work_stealing_array() noexcept {
+            slot_alloc_traits::deallocate(d_alloc, d_slots, capacity());
+        }
+        std::size_t capacity() const {
+            return d_mask + 1;
+        }
+        T get(std::int64_t index) const {
+            return d_slots[index & d_mask].load(std::memory_order_relaxed);
+        }
+        void put(std::int64_t index, const T& value){
+            d_slots[index & d_mask].store(value, std::memory_order_relaxed);
+        }
+    private:
+        std::atomic<T>*         d_slots;
+        std::size_t             d_mask;
+        slot_allocator_type     d_alloc;
+    };
+
+    //Chase-Lev work-stealing deque. the owning thread pushes and pops at the back without
+    //atomic read-modify-writes except when taking the last element; any other thread steals
+    //from the front with one CAS. the ring doubles when the owner finds it full; replaced rings
+    //stay alive until the deque is destroyed because a thief may still be reading them.
+    //elements are copied in and out of atomic slots, so T must be trivially copyable (a task pointer, an index)
+    template<typename T, typename Alloc=std::allocator<T>>
+    class work_stealing_deque {
+        static_assert(std::is_trivially_copyable<T>::value, "work_stealing_deque requires a trivially copyable type");
+    public:
+        typedef work_stealing_deque<T, Alloc>   this_type;
+        typedef Alloc                           allocator_type;
+        typedef T                               value_type;
+        typedef std::size_t                     size_type;
+        typedef T&                              reference;
+
+        typedef const value_type& param_value_type;
+    private:
+        typedef _work_stealing_array<T, Alloc>  array_type;
+    public:
+        //capacity is rounded up to a power of two
+        explicit work_stealing_deque(size_type capacity = 64, const allocator_type & alloc = allocator_type())
+            : d_top(0),d_bottom(0),d_alloc(alloc) {
+            size_type n = 1;
+            while(n < capacity){
+                n <<= 1;
+            }
+            d_array.store(new array_type(n, d_alloc), std::memory_order_relaxed);
+        }
+        work_stealing_deque(const work_stealing_deque&) = delete;
+        work_stealing_deque& operator=(const work_stealing_deque&) = delete;
+        ~work_stealing_deque() noexcept {
+            delete d_array.load(std::memory_order_relaxed);
+            for(array_type* retired : d_retired){
+                delete retired;
+            }
+        }
+
+        //owner only
+        void push_back(param_value_type value){
+            std::int64_t bottom = d_bottom.load(std::memory_order_relaxed);
+            std::int64_t top = d_top.load(std::memory_order_acquire);
+            array_type* array = d_array.load(std::memory_order_relaxed);
+            if(bottom - top > (std::int64_t)array->capacity() - 1){
+                array = grow(array, top, bottom);
+            }
+            array->put(bottom, value);
+            //a release store rather than a fence then a relaxed store: the same ordering, and
+            //thread sanitizer sees what the element points to published with it
+            d_bottom.store(bottom + 1, std::memory_order_release);
+        }
+        //owner only, takes the most recently pushed element
+        bool try_pop_back(reference value){
+            std::int64_t bottom = d_bottom.load(std::memory_order_relaxed) - 1;
+            array_type* array = d_array.load(std::memory_order_relaxed);
+            d_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = d_top.load(std::memory_order_relaxed);
+            if(top > bottom){
+                d_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return false;
+            }
+            value = array->get(bottom);
+            if(top == bottom){
+                //last element: race the thieves for it
+                bool won = d_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+                d_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+        //any thread, takes the oldest element. returns false if the deque is empty
+        //or another thread took the element first
+        bool try_steal(reference value){
+            std::int64_t top = d_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t bottom = d_bottom.load(std::memory_order_acquire);
+            if(top >= bottom){
+                return false;
+            }
+            array_type* array = d_array.load(std::memory_order_acquire);
+            value_type element = array->get(top);
+            if(!d_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)){
+                return false;
+            }
+            value = element;
+            return true;
+        }
+
+        //approximate while other threads are stealing
+        size_type size() const {
+            std::int64_t bottom = d_bottom.load(std::memory_order_relaxed);
+            std::int64_t top = d_top.load(std::memory_order_relaxed);
+            return bottom > top ? bottom - top : 0;
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+        size_type capacity() const {
+            return d_array.load(std::memory_order_relaxed)->capacity();
+        }
+    private:
+        array_type* grow(array_type* array, std::int64_t top, std::int64_t bottom){
+            array_type* bigger = new array_type(array->capacity() * 2, d_alloc);
+            for(std::int64_t i = top; i < bottom; ++i){
+                bigger->put(i, array->get(i));
+            }
+            d_retired.push_back(array);
+            d_array.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+    private:
+        _cache_line_pad                                     d_pad0;
+        std::atomic<std::int64_t>                           d_top;
+        _cache_line_pad                                     d_pad1;
+        std::atomic<std::int64_t>                           d_bottom;
+        std::atomic<array_type*>                            d_array;
+        std::vector<array_type*>                            d_retired;
+        allocator_type                                      d_alloc;
+    };
+}
+#endif